@@ -0,0 +1,56 @@
+/**
+ * @file     blockdev.h
+ * @brief    Generic block device interface
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __BLOCKDEV_H__
+#define __BLOCKDEV_H__
+
+#include <stdint.h>
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup BLOCKDEV Block device interface
+ * @{
+ */
+
+/* Result Codes */
+#define BLOCKDEV_OPER_SUCCESS                           0
+#define BLOCKDEV_OPER_FAIL                              1
+
+typedef struct block_device_t block_device;
+
+/**
+ * Storage seen as an array of bytes. Addresses and sizes passed to 'read', 'prog' and
+ * 'erase' must be multiples of 'readSize', 'progSize' and 'eraseSize' respectively;
+ * 'blockSize' is the transfer unit that costs the fewest bus transactions per byte.
+ * Every operation returns BLOCKDEV_OPER_xxx.
+ */
+struct block_device_t {
+    uint32_t size;                  //!< Bytes
+    uint32_t readSize;
+    uint32_t progSize;
+    uint32_t eraseSize;
+    uint32_t blockSize;
+
+    unsigned int (*read)(const block_device *dev, uint32_t addr, void *dst, uint32_t size);
+    unsigned int (*prog)(const block_device *dev, uint32_t addr, const void *src, uint32_t size);
+    unsigned int (*erase)(const block_device *dev, uint32_t addr, uint32_t size);
+    unsigned int (*sync)(const block_device *dev);      //!< Returns once everything written is stored
+
+    void *ctx;                      //!< Driver private data
+};
+
+ /**
+ * @}
+ */
+  /**
+ * @}
+ */
+
+#endif  /*  __BLOCKDEV_H__  */
@@ -14,8 +14,32 @@
 #define CLOCK_MODE_ONE_FOURTH_OF_CCLOCK                     (0x0)
 #define CLOCK_MODE_SAME_AS_CCLOCK                           (0x1)
 #define CLOCK_MODE_ONE_HALF_OF_CCLOCK                       (0x2)
+#define CLOCK_MODE_ONE_EIGHTH_OF_CCLOCK                     (0x3)           //!< CCLK / 6 for CAN1, CAN2 and the CAN filter
 
-#define SET_PERIPHERAL_CLOCK_MODE(pclocksel, shift, mode)   (LPC_SC->PCLKSEL##pclocksel = (LPC_SC->PCLKSEL##pclocksel & (~0x3)) | ((mode) << (shift)))
+#define CLOCK_MODE_DIVIDER(mode)                            ((0x8214 >> (4 * (mode))) & 0xF)    //!< CCLK / PCLK for a CLOCK_MODE_xxx
+
+#define SET_PERIPHERAL_CLOCK_MODE(pclocksel, shift, mode)   (LPC_SC->PCLKSEL##pclocksel = (LPC_SC->PCLKSEL##pclocksel & ~(0x3 << (shift))) | ((mode) << (shift)))
+#define GET_PERIPHERAL_CLOCK_MODE(pclocksel, shift)         ((LPC_SC->PCLKSEL##pclocksel >> (shift)) & 0x3)
+// PCLK of a peripheral, Hz, as selected. PCLKSEL is set by InitClock() before PLL0 is connected:
+// later writes may not take effect (erratum PCLKSELx.1)
+#define PERIPHERAL_CLOCK_HZ(pclocksel, shift)               (SystemCoreClock / CLOCK_MODE_DIVIDER(GET_PERIPHERAL_CLOCK_MODE(pclocksel, shift)))
+
+#define CRITICAL_ENTER(state)                               do { (state) = __get_PRIMASK(); __disable_irq(); } while(0)  //!< Masks interrupts, saving the previous state
+#define CRITICAL_EXIT(state)                                (__set_PRIMASK(state))
+
+// Fast paths run from the local SRAM, section .ramfunc, copied there at startup: no flash wait
+// states. On the declaration and on the definition, and only on functions that call nothing
+// but RAMFUNC functions and read no constants from flash (IAR warnings Ta023, Ta022): the
+// library, callbacks and lookup tables stay in flash. RAMFUNC_ENABLED 0 leaves them in flash,
+// to compare both with the profiler.
+#ifndef RAMFUNC_ENABLED
+#define RAMFUNC_ENABLED                                     1
+#endif
+#if RAMFUNC_ENABLED && defined(__ICCARM__)
+#define RAMFUNC                                             _Pragma("location=\".ramfunc\"") __ramfunc
+#else
+#define RAMFUNC
+#endif
 
  /**
  * @}
@@ -0,0 +1,72 @@
+/**
+ * @file     crc.h
+ * @brief    CRC helpers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __CRC_H__
+#define __CRC_H__
+
+#include <stdint.h>
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup CRC CRC helpers
+ * @{
+ */
+
+#define CRC16_INIT                                      0xFFFF          // CRC-16/CCITT-FALSE seed
+#define CRC32_INIT                                      0xFFFFFFFFUL    // CRC-32 (IEEE 802.3) seed
+#define CRC32_FINAL(crc)                                ((crc) ^ 0xFFFFFFFFUL)
+
+/**
+ * Updates a CRC-16/CCITT (polynomial 0x1021, MSB first) with 'size' bytes
+ *
+ * \param crc Current value, CRC16_INIT for a new computation
+ * \param data Data buffer
+ * \param size Buffer size
+ * \return The updated CRC
+ */
+uint16_t CRC16_Update(uint16_t crc, const void *data, unsigned int size);
+
+/**
+ * Updates a CRC-7 (polynomial 0x09, MSB first), as used by SD/MMC commands
+ *
+ * \param crc Current value, 0 for a new computation
+ * \param data Data buffer
+ * \param size Buffer size
+ * \return The updated CRC, 7 bits
+ */
+uint8_t CRC7_Update(uint8_t crc, const void *data, unsigned int size);
+
+/**
+ * Updates a CRC-32 (IEEE 802.3, reflected) with 'size' bytes, four bytes per step
+ *
+ * \param crc Current value, CRC32_INIT for a new computation. Apply CRC32_FINAL() to the result
+ * \param data Data buffer
+ * \param size Buffer size
+ * \return The updated CRC
+ */
+uint32_t CRC32_Update(uint32_t crc, const void *data, unsigned int size);
+
+/**
+ * Updates a CRC-32 with a single byte, for data consumed as it arrives
+ *
+ * \param crc Current value
+ * \param data Byte
+ * \return The updated CRC
+ */
+uint32_t CRC32_UpdateByte(uint32_t crc, uint8_t data);
+
+ /**
+ * @}
+ */
+  /**
+ * @}
+ */
+
+#endif  /*  __CRC_H__  */
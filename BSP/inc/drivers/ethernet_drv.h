@@ -19,6 +19,7 @@
 
 #include "LPC17xx.h"
 #include "gpio_drv.h"
+#include "common.h"
 
 /* *******************  Constants  ******************** */
 #define DWORD                           8
@@ -63,8 +64,8 @@
 //
 #define PHY_DEF_ADR                     1  //!< EPHY address
 #define PHY_DEF_ADR_SHIFT               8
-#define MII_WR_TOUT                     SystemCoreClock * 2 //!< wait ~2 seconds
-#define MII_RD_TOUT                     SystemCoreClock * 2 //!< wait ~2 seconds
+#define MII_WR_TOUT                     10                  //!< ms, a MII access takes ~30 us
+#define MII_RD_TOUT                     10                  //!< ms, a MII access takes ~30 us
 #define MCMD_WRITE                      0
 #define MCMD_READ                       1
 #define MIND_BUSY                       0x1
@@ -167,28 +168,31 @@ typedef struct desc_entry_t desc_entry;
 int ETH_Init(eth_addr *macAddr);
 
 /**
- * Returns the link and autonegotiation status
+ * Reads the link and autonegotiation status from the PHY, over MDIO: tens of microseconds.
+ * The frame calls only check the status read last, by this call or ETH_Init(): poll it now
+ * and then, from the network thread, not per frame.
  *
  * \return Returns zero if no link or 1 is link and auto-negotiation ar up
  */
-unsigned int ETH_ipUp(void);
+unsigned int ETH_isUp(void);
 
 /**
  * Checks if there are frames waiting to be read
  *
  * \return Returns 1 if there are frames to be read, zero otherwise
  */
-unsigned int ETH_Data_Received();
+RAMFUNC unsigned int ETH_Data_Received();
 
 /**
- * Copies the next frame to 'dst' address
+ * Copies the next frame to 'dst' address. Runs from RAM, and so does all it calls: to
+ * profile it, time the call from the caller.
  *
  * \param dst Destination buffer
  * \param dst Buffer's size
  *
  * \return Returns received frame's size
  */
-unsigned int ETH_Receive_Frame(void *dst, unsigned int len);
+RAMFUNC unsigned int ETH_Receive_Frame(void *dst, unsigned int len);
 
 /**
  * Send a frame
@@ -200,7 +204,7 @@ unsigned int ETH_Receive_Frame(void *dst, unsigned int len);
  * <br>
  * Returns len if successful, zero otherwise
  */
-unsigned int ETH_Send_Frame(void *src, unsigned int len);
+RAMFUNC unsigned int ETH_Send_Frame(void *src, unsigned int len);
 
 #endif /* DRIVERS_ETHERNET_DRV_H_ */
 
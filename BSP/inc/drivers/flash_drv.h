@@ -13,6 +13,7 @@
 
 #include "LPC17xx.h"
 #include "i2c_drv.h"
+#include "blockdev.h"
 
 /** @addtogroup DRIVERS
 * @{
@@ -22,7 +23,7 @@
  * @{
  */
 
-/* Geral */
+/* Geral - default part (24LC64) used by FLASH_Init() */
 #define FLASH_SIZE                                      (8 * 1024)      // Bytes - 8KB
 #define DEVICE_ADDR                                     0x50  //(0b1010000)       // EEPROM addr
 #define FLASH_DEFAULT_VALUE                             0xFF            // Flash value after erase position
@@ -30,24 +31,77 @@
 #define FLASH_PAGE_SIZE                                 (64)            // 64 Bytes
 #define FLASH_BASE_ADDR                                 0x0000U
 
+/* Largest page of any supported part, sizes the cache lines */
+#ifndef FLASH_MAX_PAGE_SIZE
+#define FLASH_MAX_PAGE_SIZE                             (256)           // 24CM02
+#endif
+
+/* Cache */
+#ifndef FLASH_CACHE_LINES
+#define FLASH_CACHE_LINES                               4               // Pages kept in the RAM write-back cache
+#endif
+
+
+/* Write cycle */
+#ifndef FLASH_READY_MARGIN_MS
+#define FLASH_READY_MARGIN_MS                           2               // ACK polling goes on this long past tWR
+#endif
+
+/* Erase flags */
+#define FLASH_ERASE_SKIP_BLANK                          (0x1)           // Read each page first and leave it alone if already erased
 
 /* Result Codes */
 #define FLASH_OPER_SUCCESS                              0
 #define FLASH_OPER_FAIL                                 1 
+#define FLASH_OPER_BUSY                                 2
+#define FLASH_OPER_MISMATCH                             3
 
-/* Macros */
-#define ADDR_TO_PAGE(addr)                              ((addr)/(FLASH_PAGE_SIZE))
-#define PAGE_TO_ADDR(page)                              ((page)*(FLASH_PAGE_SIZE))
+/* Macros - geometry of the part selected at run time */
+#define ADDR_TO_PAGE(addr)                              ((addr)/(FLASH_GetDevice()->pageSize))
+#define PAGE_TO_ADDR(page)                              ((page)*(FLASH_GetDevice()->pageSize))
+#define ADDR_TO_PAGE_OFFSET(addr)                       ((addr)%(FLASH_GetDevice()->pageSize))
 //#define TO_BIG_ENDIAN_SHORT(addr)                     (0xFFFF & (addr >> 8 | addr << 8))
 #define ushort                                          unsigned short
 #define TO_BIG_ENDIAN_SHORT(addr)                       (ushort)((((ushort) (addr)) << 8) | (((ushort) (addr)) >> 8))
 
+/// 24xx part description
+typedef struct flash_device_t {
+    uint32_t size;                  //!< Bytes
+    uint16_t pageSize;              //!< Bytes, power of two up to FLASH_MAX_PAGE_SIZE
+    uint8_t devAddr;                //!< 7-bit I2C address with the block select bits cleared
+    uint8_t addrBytes;              //!< Memory address bytes following the device address (1 or 2)
+    uint8_t blockBits;              //!< Upper address bits carried in the device address
+    uint8_t twrMs;                  //!< Maximum write cycle time
+} flash_device;
+
+extern const flash_device FLASH_24LC64;     //!< 8 KB, 64 B pages
+extern const flash_device FLASH_24LC512;    //!< 64 KB, 128 B pages
+extern const flash_device FLASH_24CM02;     //!< 256 KB, 256 B pages, A17..A16 in the device address
+
 /**
- * @brief   Flash init
+ * @brief   Flash init, for the default part (24LC64)
  * @return  nothing
  */
  void FLASH_Init(void);
 
+/**
+ * Initializes the driver for a given part. Cached data not yet flushed is discarded.
+ *
+ * \param dev Part description, must stay valid while the driver is in use
+ * \return Command's result, fails if the geometry is not supported
+ */
+unsigned int FLASH_InitDevice(const flash_device *dev);
+
+/**
+ * \return The part the driver was initialized for
+ */
+const flash_device *FLASH_GetDevice(void);
+
+/**
+ * \return The EEPROM as a generic block device (byte granular, one page per block)
+ */
+const block_device *FLASH_GetBlockDevice(void);
+
 /** Erases one or more pages. Pass the same start and end address to erase only one page
 
 \param startPage Start page
@@ -58,7 +112,38 @@ Command's result
 */
 unsigned int FLASH_ErasePages(unsigned int startPage, unsigned int endPage);
 
-/** Writes data from 'srcAddr' of FLASH_PAGE_SIZE size into 'dstAddr'
+/**
+ * Sets 'size' bytes from 'addr' to FLASH_DEFAULT_VALUE and waits for the last write cycle.
+ * Fill bytes are streamed to the bus (no RAM buffer) one page per write cycle.
+ *
+ * \param addr Start address, need not be page aligned
+ * \param size Number of bytes
+ * \param flags FLASH_ERASE_xxx
+ * \return Command's result
+ */
+unsigned int FLASH_EraseRange(unsigned int addr, unsigned int size, unsigned int flags);
+
+/**
+ * Starts an asynchronous range erase, carried out by FLASH_EraseProcess()
+ *
+ * \param addr Start address, need not be page aligned
+ * \param size Number of bytes
+ * \param flags FLASH_ERASE_xxx
+ * \return Command's result, fails if an erase is already running
+ */
+unsigned int FLASH_EraseStart(unsigned int addr, unsigned int size, unsigned int flags);
+
+/**
+ * Advances the erase started by FLASH_EraseStart(). Never waits for the EEPROM write cycle:
+ * each call handles at most one page, written or, with FLASH_ERASE_SKIP_BLANK, read and found
+ * blank, once the previous write has completed.
+ * Must be called from the same context as the other FLASH_ functions.
+ *
+ * \return FLASH_OPER_BUSY until the last page has been issued, then the command's result
+ */
+unsigned int FLASH_EraseProcess(void);
+
+/** Writes one page of data from 'srcAddr' into 'dstAddr'
 * 
 * \param dstAddr Destination address, page aligned
 * \param srcAddr Source address
@@ -68,7 +153,7 @@ unsigned int FLASH_ErasePages(unsigned int startPage, unsigned int endPage);
 unsigned int FLASH_WritePage( void *dstAddr, void *srcAddr);
 
 /**
- * Reads data from srcAddr' of FLASH_PAGE_SIZE size into 'dstAddr'
+ * Reads one page of data from srcAddr' into 'dstAddr'
  *
  * \param dstAddr Destination buffer address
  * \param srcAddr Source address of th data to be copies from flash, page aligned
@@ -88,9 +173,14 @@ unsigned int FLASH_ReadPage(void *dstAddr, void *srcAddr);
  */
 unsigned int FLASH_ReadData(void *dstAddr, void *srcAddr, unsigned int size);
 
-/** Writes 'size' bytes into a page
-* 
-* \param dstAddr Destination address, page bounded
+/** Writes 'size' bytes starting at 'dstAddr'
+*
+* The data goes into the page cache and only reaches the EEPROM when the page is
+* evicted or FLASH_Flush() is called. Bytes equal to the cached contents are not
+* marked dirty, so rewriting an unchanged value costs no bus traffic. Write-back
+* sends only the modified bytes of each page and never reads the page first.
+*
+* \param dstAddr Destination address
 * \param srcAddr Buffer address
 * \param size Buffer size
 *
@@ -98,7 +188,15 @@ unsigned int FLASH_ReadData(void *dstAddr, void *srcAddr, unsigned int size);
 */
 unsigned int FLASH_WriteData( void *dstAddr, void *srcAddr, unsigned int size);
 
+/** Writes every dirty cached page back to the EEPROM
+*
+* \return Command's result
+*/
+unsigned int FLASH_Flush(void);
+
 /** Compares a block of data referenced by 'srcAddr' with a block referenced bu 'dstAddr' of size 'size'
+*
+* The cache is flushed first, so the comparison is made against the EEPROM contents.
 * 
 * \param dstAddr First block address
 * \param srcAddr Second block address
@@ -108,6 +206,31 @@ unsigned int FLASH_WriteData( void *dstAddr, void *srcAddr, unsigned int size);
 */
 unsigned int FLASH_VerifyData(void *dstAddr, void *srcAddr, unsigned int size);
 
+/**
+ * Computes the CRC-32 (IEEE 802.3) of an EEPROM range as it is read, without buffering it.
+ * The cache is flushed first.
+ *
+ * \param addr Start address
+ * \param size Number of bytes
+ * \param crc Resulting CRC
+ * \return Command's result
+ */
+unsigned int FLASH_ComputeCrc32(unsigned int addr, unsigned int size, uint32_t *crc);
+
+/**
+ * Streams an EEPROM range through CRC-32 and checks it page by page against 'pageCrc'.
+ * Entry i is the CRC-32 of the bytes of the range falling in its i-th page, so partial
+ * first and last pages are supported. The read stops at the first mismatching page.
+ * The cache is flushed first.
+ *
+ * \param addr Start address
+ * \param size Number of bytes
+ * \param pageCrc Expected digests, one per page touched by the range
+ * \param badPage Set to the first mismatching page on FLASH_OPER_MISMATCH
+ * \return Command's result, FLASH_OPER_MISMATCH if a page differs
+ */
+unsigned int FLASH_VerifyCrc32(unsigned int addr, unsigned int size, const uint32_t *pageCrc, unsigned int *badPage);
+
 
  /**
  * @}
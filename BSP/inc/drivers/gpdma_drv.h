@@ -0,0 +1,144 @@
+/**
+ * @file     gpdma_drv.h
+ * @brief    General purpose DMA headers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __GPDMA_DRV_H__
+#define __GPDMA_DRV_H__
+
+#include <stdint.h>
+
+#include "LPC17xx.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup GPDMA GPDMA Driver
+ * @{
+ */
+
+#define GPDMA_CHANNELS                      8
+#define GPDMA_MAX_TRANSFER                  4095                //!< Transfers per linked list item
+
+#define PCONP_GPDMA_BIT_SHIFT               (29)
+#define SET_GPDMA_POWER_ON                  (LPC_SC->PCONP |= (0x1 << PCONP_GPDMA_BIT_SHIFT))
+#define SET_GPDMA_POWER_OFF                 (LPC_SC->PCONP &= ~(0x1 << PCONP_GPDMA_BIT_SHIFT))
+
+// DMACConfig
+#define GPDMA_CONFIG_ENABLE                 (0x1 << 0)
+
+// Channel control
+#define GPDMA_CTRL_SIZE_MASK                (0xFFF)
+#define GPDMA_CTRL_SBSIZE(burst)            ((burst) << 12)
+#define GPDMA_CTRL_DBSIZE(burst)            ((burst) << 15)
+#define GPDMA_CTRL_SWIDTH(width)            ((width) << 18)
+#define GPDMA_CTRL_DWIDTH(width)            ((width) << 21)
+#define GPDMA_CTRL_SI                       (0x1 << 26)         //!< Source increment
+#define GPDMA_CTRL_DI                       (0x1 << 27)         //!< Destination increment
+#define GPDMA_CTRL_I                        (0x1UL << 31)       //!< Terminal count interrupt
+#define GPDMA_CTRL_SWIDTH_SHIFT             (18)
+
+#define GPDMA_BURST_1                       (0x0)
+#define GPDMA_BURST_4                       (0x1)
+#define GPDMA_BURST_8                       (0x2)
+#define GPDMA_WIDTH_BYTE                    (0x0)
+#define GPDMA_WIDTH_HALFWORD                (0x1)
+#define GPDMA_WIDTH_WORD                    (0x2)
+
+// Channel configuration
+#define GPDMA_CH_ENABLE                     (0x1 << 0)
+#define GPDMA_CH_SRC_PERIPH(req)            ((req) << 1)
+#define GPDMA_CH_DST_PERIPH(req)            ((req) << 6)
+#define GPDMA_CH_M2M                        (0x0 << 11)
+#define GPDMA_CH_M2P                        (0x1 << 11)
+#define GPDMA_CH_P2M                        (0x2 << 11)
+#define GPDMA_CH_IE                         (0x1 << 14)         //!< Error interrupt
+#define GPDMA_CH_ITC                        (0x1 << 15)         //!< Terminal count interrupt
+#define GPDMA_CH_ACTIVE                     (0x1 << 17)
+#define GPDMA_CH_HALT                       (0x1 << 18)
+
+// Peripheral request lines
+#define GPDMA_REQ_SSP0_TX                   (0)
+#define GPDMA_REQ_SSP0_RX                   (1)
+#define GPDMA_REQ_SSP1_TX                   (2)
+#define GPDMA_REQ_SSP1_RX                   (3)
+
+// Completion status
+#define GPDMA_STATUS_DONE                   (0)
+#define GPDMA_STATUS_ERROR                  (1)
+
+// Result Codes
+#define GPDMA_OPER_SUCCESS                  (0)
+#define GPDMA_OPER_FAIL                     (1)
+
+/// Linked list item, loaded by the controller when the current one completes. Word aligned.
+typedef struct gpdma_lli_t {
+    uint32_t srcAddr;
+    uint32_t dstAddr;
+    uint32_t nextLLI;                       //!< Next item, 0 for the last one
+    uint32_t control;
+} gpdma_lli;
+
+/// Called from GPDMA_IRQHandler when a channel completes or fails
+typedef void (*gpdma_callback)(unsigned int channel, unsigned int status, void *ctx);
+
+/**
+ * Powers and enables the controller, all channels stopped
+ */
+void GPDMA_Init(void);
+
+/**
+ * Splits a transfer into linked list items of at most GPDMA_MAX_TRANSFER elements.
+ * Addresses advance by the source width where GPDMA_CTRL_SI / GPDMA_CTRL_DI are set.
+ * Only the last item requests the terminal count interrupt.
+ *
+ * \param lli Items to fill
+ * \param maxItems Number of items available
+ * \param srcAddr Source address
+ * \param dstAddr Destination address
+ * \param count Number of elements (source width)
+ * \param control Channel control without the transfer size nor GPDMA_CTRL_I
+ * \return Number of items used, 0 if 'maxItems' is too small
+ */
+unsigned int GPDMA_BuildChain(gpdma_lli *lli, unsigned int maxItems, uint32_t srcAddr, uint32_t dstAddr,
+                              unsigned int count, uint32_t control);
+
+/**
+ * Starts a channel on a chain built by GPDMA_BuildChain(). The first item is loaded into the
+ * channel registers, so it may live on the stack; the following ones must stay valid until
+ * completion.
+ *
+ * \param channel Channel number, 0 has the highest priority
+ * \param lli First item
+ * \param config Channel configuration (GPDMA_CH_xxx), enable and interrupt bits are added
+ * \param callback Completion callback, may be 0
+ * \param ctx Passed to 'callback'
+ * \return Command's result, fails if the channel is busy
+ */
+unsigned int GPDMA_Start(unsigned int channel, const gpdma_lli *lli, uint32_t config, gpdma_callback callback, void *ctx);
+
+/**
+ * Stops a channel, discarding the data still in its FIFO. The callback is not called.
+ *
+ * \param channel Channel number
+ */
+void GPDMA_Stop(unsigned int channel);
+
+/**
+ * \param channel Channel number
+ * \return 1 while the channel is enabled
+ */
+unsigned int GPDMA_IsBusy(unsigned int channel);
+
+ /**
+ * @}
+ */
+  /**
+ * @}
+ */
+
+#endif  /*  __GPDMA_DRV_H__  */
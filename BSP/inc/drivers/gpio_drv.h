@@ -28,6 +28,21 @@
 #define SET_PIN_OFF(gpio_idx, pinId)                (LPC_GPIO##gpio_idx->FIOCLR |= (0x1 << (pinId)))    //!< Word access
 #define GET_PIN_STATE(gpio_idx, pinId)              (LPC_GPIO##gpio_idx->FIOPIN & ((0x1) << (pinId)))   //!< Word access
 #define GET_PIN_GROUP_STATE(gpio_idx, mask)         (LPC_GPIO##gpio_idx->FIOPIN & (mask))               //!< Word access
+//
+#define GPIO_PORT(port)                             ((LPC_GPIO_TypeDef *)(LPC_GPIO0_BASE + 0x20 * (port)))  //!< GPIO block of a port number
+
+// Pins of board.h, named after the registers of the IAR I/O header (LCD_CS_FDIR is FIO1DIR), as
+// the port and pin numbers of the drivers: BOARD_PORT(LCD_CS_FDIR), BOARD_PIN(LCD_CS_MASK)
+#define BOARD_PORT(fdir)                            BOARD_PORT_OF(fdir)
+#define BOARD_PORT_OF(fdir)                         BOARD_PORT_##fdir
+#define BOARD_PORT_FIO0DIR                          0
+#define BOARD_PORT_FIO1DIR                          1
+#define BOARD_PORT_FIO2DIR                          2
+#define BOARD_PORT_FIO3DIR                          3
+#define BOARD_PORT_FIO4DIR                          4
+#define BOARD_PIN(mask)                             ((((mask) & 0xFFFF0000UL)? 16 : 0) + (((mask) & 0xFF00FF00UL)? 8 : 0) \
+                                                     + (((mask) & 0xF0F0F0F0UL)? 4 : 0) + (((mask) & 0xCCCCCCCCUL)? 2 : 0) \
+                                                     + (((mask) & 0xAAAAAAAAUL)? 1 : 0))
 
  /**
  * @}
@@ -35,6 +35,10 @@
 #define I2C0_INIT_MASK                      (I2C0_EN_BIT | I2C0_BIT_AA)
 #define I2C0_OPER_MODE_MASTER               (0x0)
 #define I2C0_OPER_MODE_SLAVE                (0x1)
+// Timeout
+#ifndef I2C0_TIMEOUT_US
+#define I2C0_TIMEOUT_US                     (1000)              //!< Longest bus operation, a byte takes 90 us at 100 kHz
+#endif
 // Status for user
 #define I2C_OPERATION_OK                    (0x1)
 #define I2C_OPERATION_NOK                   (0x0)
@@ -56,6 +60,9 @@
 #define WRITE_OPERATION                     (0x0)
 #define READ_OPERATION                      (0x1)
 
+/// Called for every byte received by I2C0_Receive_Stream. Returning non-zero ends the transfer
+typedef int (*i2c_rx_handler)(char data, void *ctx);
+
 
 #define SET_I2C0_POWER_ON                   (LPC_SC->PCONP |= (0x1 << PCONP_I2C0_BIT_SHIFT))
 #define SET_I2C0_POWER_OFF                  (LPC_SC->PCONP &= ~(0x1 << PCONP_I2C0_BIT_SHIFT))
@@ -122,6 +129,16 @@ int I2C0_Stop_Comunication(void);
  */
 int I2C0_Send_Data(char *data, int len);
 
+/**
+ * Sends the same byte len times
+ * \param value Byte to be sent
+ * \param len Number of bytes
+ * \return int
+ * <br>
+ * The operation result
+ */
+int I2C0_Send_Fill(char value, int len);
+
 
 /**
  * Reads one byte
@@ -143,6 +160,19 @@ int I2C0_Receive_Byte(char *buff);
  */
 int I2C0_Receive_Data(char *buff, int len);
 
+/*
+ * Receives up to 'len' bytes handing each one to 'handler' as it arrives, without buffering.
+ * The transfer is NACKed early when the handler returns non-zero.
+ *
+ * \param len Maximum number of bytes
+ * \param handler Byte handler
+ * \param ctx Handler's context
+ * \return int
+ * <br>
+ * The operation result
+ */
+int I2C0_Receive_Stream(int len, i2c_rx_handler handler, void *ctx);
+
 #endif /* DRIVERS_I2C_DRV_H_ */
 
 
@@ -0,0 +1,114 @@
+/**
+ * @file     irq_drv.h
+ * @brief    Headers for the interrupt configuration
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __IRQ_DRV_H__
+#define __IRQ_DRV_H__
+
+#include <stdint.h>
+
+#include "LPC17xx.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup IRQ Interrupt configuration
+ *
+ * Every interrupt of the project is listed once in IRQ_TABLE, with its preemption priority,
+ * its sub-priority and whether it is enabled at startup; IRQ_Init() applies the table in one
+ * pass, after giving every other interrupt IRQ_DEFAULT_PREEMPT. The table is checked at compile time: unknown interrupt, priority out of range,
+ * enabling a core exception or listing one twice fail the build. Lower values are more
+ * urgent; a handler is only preempted by interrupts of a lower preemption priority.
+ *
+ * With IRQ_RAM_VECTORS, IRQ_Init() also copies the vector table to RAM and points VTOR at
+ * it: vectors are fetched from SRAM without flash wait states, and irq_register() swaps
+ * handlers at run time without relinking.
+ * @{
+ */
+
+#define IRQ_PREEMPT_BITS                    3                   // 8 preemption levels...
+#define IRQ_SUB_BITS                        (__NVIC_PRIO_BITS - IRQ_PREEMPT_BITS)  // ...of 4 sub-priorities
+#define IRQ_PRIORITY_GROUP                  (7 - IRQ_PREEMPT_BITS)                 // SCB->AIRCR PRIGROUP
+#if IRQ_PREEMPT_BITS > __NVIC_PRIO_BITS
+#error "IRQ_PREEMPT_BITS exceeds the implemented priority bits"
+#endif
+
+#ifndef IRQ_RAM_VECTORS
+#define IRQ_RAM_VECTORS                     1
+#endif
+#define IRQ_VECTORS                         (16 + 35)           // Core exceptions, then the LPC17xx IRQs
+
+/* Result Codes */
+#define IRQ_OPER_SUCCESS                    0
+#define IRQ_OPER_FAIL                       1
+
+#define IRQ_LOWEST_PREEMPT                  ((0x1 << IRQ_PREEMPT_BITS) - 1)
+#define IRQ_LOWEST_SUB                      ((0x1 << IRQ_SUB_BITS) - 1)
+#define IRQ_DEFAULT_PREEMPT                 (IRQ_LOWEST_PREEMPT - 1)    // Interrupts not in IRQ_TABLE
+#if IRQ_DEFAULT_PREEMPT < 1
+#error "Interrupts not in IRQ_TABLE must stay below the memory management fault"
+#endif
+
+/// Priority register value, for NVIC_SetPriority()
+#define IRQ_PRIORITY(preempt, sub)          (((preempt) << IRQ_SUB_BITS) | (sub))
+
+/**
+ * Project's interrupts: IRQ(number, preemption priority, sub-priority, enabled at startup).
+ * Drivers still enable their own interrupt when they start; 'enabled' is for those that do
+ * not. The memory management fault preempts every interrupt, those missing from the table
+ * included, so that a stack overflow in a handler does not escalate; then the time base; the
+ * network path preempts the storage path; interrupts missing from the table come next, at
+ * IRQ_DEFAULT_PREEMPT; the kernel's PendSV and SysTick stay below everything.
+ */
+#define IRQ_TABLE(IRQ) \
+    IRQ(MemoryManagement_IRQn, 0, 0, 0) /* Stack guard, stack.h */ \
+    IRQ(TIMER0_IRQn,    1,  0,  0)      /* Time base, software timers, kernel timeouts */ \
+    IRQ(ENET_IRQn,      2,  0,  0)      /* Frames to the network thread */ \
+    IRQ(DMA_IRQn,       3,  0,  0)      /* SSP transfers: LCD, SD, flash */ \
+    IRQ(SSP0_IRQn,      3,  1,  0) \
+    IRQ(SSP1_IRQn,      3,  1,  0) \
+    IRQ(I2C0_IRQn,      4,  0,  0)      /* EEPROM */ \
+    IRQ(SysTick_IRQn,   IRQ_LOWEST_PREEMPT, IRQ_LOWEST_SUB, 0) \
+    IRQ(PendSV_IRQn,    IRQ_LOWEST_PREEMPT, IRQ_LOWEST_SUB, 0)
+
+/// An exception handler
+typedef void (*irq_handler)(void);
+
+/**
+ * Moves the vectors to RAM if IRQ_RAM_VECTORS, sets the priority grouping, IRQ_DEFAULT_PREEMPT
+ * on every interrupt then the priorities of IRQ_TABLE, and enables those marked so. First thing at startup, before the drivers.
+ */
+void IRQ_Init(void);
+
+/**
+ * Changes the priority of an interrupt at run time
+ *
+ * \param irq Interrupt number, core exceptions included
+ * \param preempt 0 to IRQ_LOWEST_PREEMPT
+ * \param sub 0 to IRQ_LOWEST_SUB
+ */
+void IRQ_SetPriority(IRQn_Type irq, unsigned int preempt, unsigned int sub);
+
+/**
+ * Installs a handler, taking effect from the next time the interrupt is taken. Needs
+ * IRQ_RAM_VECTORS and IRQ_Init().
+ *
+ * \param irq Interrupt number, core exceptions from MemoryManagement_IRQn on included
+ * \param handler Handler, a plain C function
+ * \return Command's result
+ */
+unsigned int irq_register(IRQn_Type irq, irq_handler handler);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __IRQ_DRV_H__ */
@@ -0,0 +1,131 @@
+/**
+ * @file     irqtrace.h
+ * @brief    Headers for the interrupt tracer
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __IRQTRACE_H__
+#define __IRQTRACE_H__
+
+#include <stdint.h>
+
+#include "LPC17xx.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup IRQTRACE Interrupt tracer
+ *
+ * Handlers call IRQTRACE_ENTER() first and IRQTRACE_EXIT() last. Each call stores an event,
+ * DWT cycle counter and exception number, in a ring that keeps the latest IRQTRACE_EVENTS;
+ * slots are taken with LDREX/STREX, so nested handlers never wait on each other. Per
+ * exception, the latency from the event that raised the interrupt (when the handler can tell,
+ * e.g. the timer match) and the duration, nested handlers included, are summed up.
+ *
+ * IRQTRACE_Export() streams the ring in the format below, tools/irqtrace_decode.py turns it
+ * into a timeline. All little endian:
+ *     header: "IRQT", version (1), event size (8), 2 reserved, core clock Hz (4),
+ *             events that follow (4), events lost to the ring wrapping (4)
+ *     event:  cycles (4), exception number (1), IRQTRACE_EVENT_xxx (1), latency cycles (2),
+ *             oldest first
+ *
+ * Opt-in: built with IRQTRACE_ENABLED 0, the default, the macros are empty.
+ * @{
+ */
+
+#ifndef IRQTRACE_ENABLED
+#define IRQTRACE_ENABLED                    0
+#endif
+#ifndef IRQTRACE_EVENTS
+#define IRQTRACE_EVENTS                     256                 // Power of two
+#endif
+#if IRQTRACE_EVENTS & (IRQTRACE_EVENTS - 1)
+#error "IRQTRACE_EVENTS must be a power of two"
+#endif
+#define IRQTRACE_EXCEPTIONS                 (16 + 35)           // Core exceptions, then the LPC17xx IRQs
+#define IRQTRACE_NO_LATENCY                 0xFFFF
+#define IRQTRACE_MAX_LATENCY                0xFFFE              // Exported latencies saturate here, clear of IRQTRACE_NO_LATENCY
+#define IRQTRACE_FORMAT_VERSION             1
+
+#define IRQTRACE_EVENT_ENTER                0
+#define IRQTRACE_EVENT_EXIT                 1
+
+#if IRQTRACE_ENABLED
+#define IRQTRACE_ENTER(latency)             IRQTRACE_Enter(latency)
+#define IRQTRACE_EXIT()                     IRQTRACE_Exit()
+#else
+#define IRQTRACE_ENTER(latency)
+#define IRQTRACE_EXIT()
+#endif
+
+/// A traced event, as exported
+typedef struct irqtrace_event_t {
+    uint32_t cycles;                        //!< DWT CYCCNT
+    uint8_t exception;                      //!< IRQn + 16
+    uint8_t kind;                           //!< IRQTRACE_EVENT_xxx
+    uint16_t latency;                       //!< Entries: cycles up to IRQTRACE_MAX_LATENCY, or IRQTRACE_NO_LATENCY
+} irqtrace_event;
+
+/// Statistics of an exception, in cycles
+typedef struct irqtrace_stats_t {
+    uint32_t count;
+    uint32_t latencyCount;                  //!< Entries with a known latency
+    uint32_t latencyMin;
+    uint32_t latencyMax;
+    uint64_t latencyTotal;
+    uint32_t durationMin;
+    uint32_t durationMax;
+    uint64_t durationTotal;
+} irqtrace_stats;
+
+/// Receives the export, a piece at a time
+typedef void (*irqtrace_output)(const void *data, unsigned int len, void *ctx);
+
+/**
+ * Starts the cycle counter, clears the trace and starts recording
+ */
+void IRQTRACE_Init(void);
+
+/**
+ * Records a handler entry, from the handler. Use IRQTRACE_ENTER().
+ *
+ * \param latency Cycles from the interrupt request, IRQTRACE_NO_LATENCY if not known
+ */
+void IRQTRACE_Enter(uint32_t latency);
+
+/**
+ * Records a handler exit, from the handler. Use IRQTRACE_EXIT().
+ */
+void IRQTRACE_Exit(void);
+
+/**
+ * \param exception IRQn + 16
+ * \return Its statistics, 0 if out of range
+ */
+const irqtrace_stats *IRQTRACE_GetStats(unsigned int exception);
+
+/**
+ * Clears the statistics and the ring
+ */
+void IRQTRACE_Reset(void);
+
+/**
+ * Streams the trace, recording being paused meanwhile. From thread mode only: handlers that
+ * were recording are then done.
+ *
+ * \param output Receiver
+ * \param ctx For the receiver
+ */
+void IRQTRACE_Export(irqtrace_output output, void *ctx);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __IRQTRACE_H__ */
@@ -0,0 +1,188 @@
+/**
+ * @file     kernel.h
+ * @brief    Headers for the preemptive kernel
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __KERNEL_H__
+#define __KERNEL_H__
+
+#include <stdint.h>
+
+#include "swtimer.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup KERNEL Preemptive kernel
+ *
+ * Fixed priority threads. The highest priority ready thread always runs; threads of the
+ * same priority share the core in SysTick slices. Switches happen in PendSV, the lowest
+ * priority exception, so an interrupt that readies a thread gets it running as soon as the
+ * interrupt returns. Threads block on sleeps, mutexes (with priority inheritance) and
+ * message queues; timeouts run on the software timers. Blocking calls are made from threads,
+ * never with interrupts masked.
+ * @{
+ */
+
+#define KERNEL_PRIORITIES                   32                  // 0 is the lowest, the idle thread's
+#ifndef KERNEL_SLICE_MS
+#define KERNEL_SLICE_MS                     10                  // Round robin between threads of equal priority
+#endif
+#ifndef KERNEL_IDLE_STACK_WORDS
+#define KERNEL_IDLE_STACK_WORDS             64
+#endif
+#define KERNEL_MIN_STACK_WORDS              32                  // Exception frame, saved registers and some margin
+#define KERNEL_WAIT_FOREVER                 0xFFFFFFFF
+
+/* Result Codes */
+#define KERNEL_OPER_SUCCESS                 0
+#define KERNEL_OPER_FAIL                    1
+#define KERNEL_OPER_TIMEOUT                 2
+
+typedef struct kernel_thread_t kernel_thread;
+typedef struct kernel_mutex_t kernel_mutex;
+
+typedef void (*kernel_entry)(void *arg);
+
+/// A thread. Owned by the caller, it must stay valid while the thread exists.
+struct kernel_thread_t {
+    uint32_t *sp;                           //!< Saved stack pointer, first for the PendSV handler
+    kernel_thread *next;                    //!< In a ready list or in a wait list
+    unsigned char priority;                 //!< Effective, raised by the mutexes it holds
+    unsigned char basePriority;
+    unsigned char state;
+    void *waitingOn;                        //!< Mutex or queue it is blocked on
+    void *message;                          //!< Item being sent or received while blocked
+    kernel_mutex *mutexes;                  //!< Held
+    volatile unsigned int result;           //!< KERNEL_OPER_xxx of the last wait
+    swtimer timeout;
+    uint32_t *stack;                        //!< Lowest address
+    unsigned int stackWords;
+};
+
+/// A mutex, recursive
+struct kernel_mutex_t {
+    kernel_thread *owner;
+    kernel_thread *waiters;                 //!< By priority
+    kernel_mutex *nextHeld;                 //!< In owner->mutexes
+    unsigned int count;
+};
+
+/// A message queue of fixed size items, copied in and out
+typedef struct kernel_queue_t {
+    uint8_t *buffer;
+    unsigned int itemSize;
+    unsigned int capacity;
+    unsigned int count;
+    unsigned int head;
+    kernel_thread *senders;                 //!< Waiting for room, by priority
+    kernel_thread *receivers;               //!< Waiting for an item, by priority
+} kernel_queue;
+
+/**
+ * Prepares the kernel. SWTIMER_Init() must have been called.
+ */
+void KERNEL_Init(void);
+
+/**
+ * Creates a thread, ready to run
+ *
+ * \param thread Thread
+ * \param stack Stack, 8 bytes aligned
+ * \param stackWords Stack size, at least KERNEL_MIN_STACK_WORDS
+ * \param entry Thread's function. Returning from it ends the thread.
+ * \param arg For 'entry'
+ * \param priority 1 to KERNEL_PRIORITIES - 1
+ * \return Command's result
+ */
+unsigned int KERNEL_CreateThread(kernel_thread *thread, uint32_t *stack, unsigned int stackWords,
+                                 kernel_entry entry, void *arg, unsigned int priority);
+
+/**
+ * Starts the threads, does not return. The main stack is left to the interrupts.
+ * The host port of the tests returns once every thread is blocked for good.
+ */
+void KERNEL_Start(void);
+
+/**
+ * \return The running thread, 0 before KERNEL_Start()
+ */
+kernel_thread *KERNEL_Self(void);
+
+/**
+ * Lets the other ready threads of the same priority run
+ */
+void KERNEL_Yield(void);
+
+/**
+ * Blocks the running thread
+ *
+ * \param ms Milliseconds
+ */
+void KERNEL_Sleep(unsigned int ms);
+
+void KERNEL_MutexInit(kernel_mutex *mutex);
+
+/**
+ * Takes a mutex, waiting as long as needed. Meanwhile the owner runs at least at the
+ * caller's priority.
+ *
+ * \return Command's result, fails outside a thread
+ */
+unsigned int KERNEL_MutexLock(kernel_mutex *mutex);
+
+/**
+ * Releases a mutex taken by the running thread
+ *
+ * \return Command's result, fails if the running thread does not own it
+ */
+unsigned int KERNEL_MutexUnlock(kernel_mutex *mutex);
+
+/**
+ * \param queue Queue
+ * \param buffer capacity * itemSize bytes
+ * \param itemSize Bytes per item
+ * \param capacity Items, at least 1
+ * \return Command's result
+ */
+unsigned int KERNEL_QueueInit(kernel_queue *queue, void *buffer, unsigned int itemSize, unsigned int capacity);
+
+/**
+ * Copies an item in, waiting for room
+ *
+ * \param queue Queue
+ * \param item Item
+ * \param timeoutMs 0 not to wait, KERNEL_WAIT_FOREVER
+ * \return Command's result, fails outside a thread
+ */
+unsigned int KERNEL_QueueSend(kernel_queue *queue, const void *item, unsigned int timeoutMs);
+
+/**
+ * Copies an item in without waiting. Callable from interrupts.
+ *
+ * \return Command's result, fails if the queue is full
+ */
+unsigned int KERNEL_QueueSendFromISR(kernel_queue *queue, const void *item);
+
+/**
+ * Copies the oldest item out, waiting for one
+ *
+ * \param queue Queue
+ * \param item Receives the item
+ * \param timeoutMs 0 not to wait, KERNEL_WAIT_FOREVER
+ * \return Command's result, fails outside a thread
+ */
+unsigned int KERNEL_QueueReceive(kernel_queue *queue, void *item, unsigned int timeoutMs);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __KERNEL_H__ */
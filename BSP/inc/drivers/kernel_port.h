@@ -0,0 +1,45 @@
+/**
+ * @file     kernel_port.h
+ * @brief    Headers for the processor port of the preemptive kernel
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * kernel.c holds the scheduling core and reaches the processor only through the functions
+ * below and PendSV: to switch, it sets kernelNext and pends PendSV (SCB->ICSR), and the port
+ * makes kernelNext the running thread once interrupts are unmasked and no handler is active.
+ * The Cortex-M3 port is kernel_cm3.c with kernel_port.s; the host tests bring their own.
+ *
+ **/
+
+#ifndef __KERNEL_PORT_H__
+#define __KERNEL_PORT_H__
+
+#include <stdint.h>
+
+#include "kernel.h"
+
+extern kernel_thread *volatile kernelCurrent;   //!< Whose context is in the core
+extern kernel_thread *volatile kernelNext;      //!< To switch to
+
+/**
+ * Prepares a stack so that switching to it starts 'entry'
+ *
+ * \param stack Lowest address
+ * \param stackWords Size
+ * \param entry Thread's function
+ * \param arg For 'entry'
+ * \param end Where 'entry' returns to
+ * \return The stack pointer to save in kernel_thread.sp
+ */
+uint32_t *KERNEL_PortInitStack(uint32_t *stack, unsigned int stackWords, kernel_entry entry, void *arg,
+                               void (*end)(void));
+
+/**
+ * Starts the time slices and switches to kernelNext, without saving the calling context.
+ * Does not return.
+ *
+ * \param slice Called every KERNEL_SLICE_MS, from the lowest priority exception
+ */
+void KERNEL_PortStart(void (*slice)(void));
+
+#endif /* __KERNEL_PORT_H__ */
@@ -0,0 +1,106 @@
+/**
+ * @file     kvstore.h
+ * @brief    Headers for the EEPROM key/value store
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __KVSTORE_H__
+#define __KVSTORE_H__
+
+#include <stdint.h>
+
+#include "flash_drv.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup KVSTORE Key/value store
+ *
+ * Log-structured store on top of the EEPROM driver. The region is split in two banks;
+ * records are only appended to the active one and, when it is full, the live values are
+ * copied into the other bank, whose header is written last to commit the switch.
+ * Every record carries the bank generation and a CRC, so a record torn by a power loss
+ * is simply ignored on the next KVS_Init(). The last record is followed by a terminator reading
+ * as erased, so that what an earlier use of the bank left behind is never replayed, whatever its
+ * generation. All values are mirrored in RAM.
+ * @{
+ */
+
+/* Geometry */
+#ifndef KVS_BASE_ADDR
+#define KVS_BASE_ADDR                                   (FLASH_SIZE / 2)        // Upper half of the EEPROM
+#endif
+#ifndef KVS_SIZE
+#define KVS_SIZE                                        (FLASH_SIZE / 2)
+#endif
+#define KVS_BANK_SIZE                                   (KVS_SIZE / 2)
+
+/* Limits */
+#ifndef KVS_MAX_KEYS
+#define KVS_MAX_KEYS                                    32
+#endif
+#ifndef KVS_MAX_VALUE_SIZE
+#define KVS_MAX_VALUE_SIZE                              16              // Bytes
+#endif
+#define KVS_INVALID_KEY                                 0xFFFF          // Reads as erased EEPROM
+
+/* Result Codes */
+#define KVS_OPER_SUCCESS                                0
+#define KVS_OPER_FAIL                                   1
+#define KVS_NOT_FOUND                                   2
+#define KVS_NO_SPACE                                    3
+
+/**
+ * Mounts the store: picks the newest valid bank and rebuilds the RAM index from its log.
+ * A blank region is formatted. FLASH_Init() must have been called.
+ *
+ * \return Command's result
+ */
+unsigned int KVS_Init(void);
+
+/**
+ * Copies the value of 'key' from the RAM index. The EEPROM is not accessed.
+ *
+ * \param key Key
+ * \param value Destination buffer
+ * \param size In: buffer size. Out: value size
+ * \return Command's result, KVS_NOT_FOUND if the key is not stored
+ */
+unsigned int KVS_Get(uint16_t key, void *value, unsigned int *size);
+
+/**
+ * Stores a value. Nothing is written if the stored value is already the same.
+ *
+ * \param key Key, any value but KVS_INVALID_KEY
+ * \param value Source buffer
+ * \param size Value size, 1 to KVS_MAX_VALUE_SIZE
+ * \return Command's result
+ */
+unsigned int KVS_Set(uint16_t key, const void *value, unsigned int size);
+
+/**
+ * Removes a key
+ *
+ * \param key Key
+ * \return Command's result, KVS_NOT_FOUND if the key is not stored
+ */
+unsigned int KVS_Delete(uint16_t key);
+
+/**
+ * Copies the live values into the other bank and switches to it
+ *
+ * \return Command's result
+ */
+unsigned int KVS_Compact(void);
+
+ /**
+ * @}
+ */
+  /**
+ * @}
+ */
+
+#endif  /*  __KVSTORE_H__  */
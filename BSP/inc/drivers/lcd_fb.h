@@ -0,0 +1,118 @@
+/**
+ * @file     lcd_fb.h
+ * @brief    LCD framebuffer headers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __LCD_FB_H__
+#define __LCD_FB_H__
+
+#include <stdint.h>
+
+#include "spi_bus.h"
+#include "gpio_drv.h"
+#include "board.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+ /** @defgroup LCD_FB LCD framebuffer
+ * @{
+ */
+
+/* PCF8833 132x132 panel of the IAR LPC-1768-SK: SSP0, 9-bit frames, the LCD pins of board.h */
+#define LCD_FB_WIDTH                        132
+#define LCD_FB_HEIGHT                       132
+#define LCD_FB_SSP_PORT                     SSP_PORT0
+#define LCD_FB_CS_PORT                      BOARD_PORT(LCD_CS_FDIR)             // P1.21
+#define LCD_FB_CS_PIN                       BOARD_PIN(LCD_CS_MASK)
+#define LCD_FB_RST_PORT                     BOARD_PORT(LCD_RST_FDIR)            // P3.25, LCD_RST_MASK
+#define LCD_FB_BL_PORT                      BOARD_PORT(LCD_BL_FDIR)             // P3.26, LCD_BL_MASK
+#ifndef LCD_FB_FREQUENCY
+#define LCD_FB_FREQUENCY                    6500000             // Hz, PCF8833 limit
+#endif
+#ifndef LCD_FB_MADCTL
+#define LCD_FB_MADCTL                       0x00                // Scan direction, depends on how the glass is mounted
+#endif
+#ifndef LCD_FB_CONTRAST
+#define LCD_FB_CONTRAST                     0x30
+#endif
+
+#ifndef LCD_FB_MAX_DIRTY
+#define LCD_FB_MAX_DIRTY                    8                   // Rectangles tracked between flushes
+#endif
+#ifndef LCD_FB_STAGING_WORDS
+#define LCD_FB_STAGING_WORDS                (2 * LCD_FB_WIDTH)  // 9-bit words per DMA transfer, two such buffers
+#endif
+
+/* RGB332 pixels */
+#define LCD_RGB(r, g, b)                    (((r) & 0xE0) | (((g) >> 3) & 0x1C) | ((b) >> 6))
+#define LCD_BLACK                           0x00
+#define LCD_WHITE                           0xFF
+
+/* Result Codes */
+#define LCD_FB_OPER_SUCCESS                 0
+#define LCD_FB_OPER_FAIL                    1
+#define LCD_FB_OPER_BUSY                    2
+
+/**
+ * Resets and configures the panel (8 bits per pixel), clears it and turns the backlight on.
+ * SPIBUS_Init(LCD_FB_SSP_PORT) must have been called.
+ *
+ * \return Command's result
+ */
+unsigned int LCDFB_Init(void);
+
+/**
+ * \return The frame buffer, LCD_FB_HEIGHT rows of LCD_FB_WIDTH pixels. It is the only copy of
+ * the frame: a flush reads it as it goes, see LCDFB_Flush(). Call LCDFB_Invalidate() on what is
+ * changed through it.
+ */
+uint8_t *LCDFB_GetBuffer(void);
+
+/**
+ * Marks a region as changed. Overlapping and neighbouring regions are merged.
+ *
+ * \param x Left column
+ * \param y Top row
+ * \param width Columns
+ * \param height Rows
+ */
+void LCDFB_Invalidate(int x, int y, int width, int height);
+
+/**
+ * Sets a pixel, clipped
+ */
+void LCDFB_SetPixel(int x, int y, uint8_t color);
+
+/**
+ * Fills a rectangle, clipped
+ */
+void LCDFB_FillRect(int x, int y, int width, int height, uint8_t color);
+
+/**
+ * Starts sending the changed regions to the panel and returns. The transfer is double-buffered,
+ * not the frame: two staging buffers are refilled from the frame buffer, a few rows ahead of
+ * the wire. Drawing may go on meanwhile, but a region drawn while it is being sent can reach
+ * the panel half old, half new; it is marked dirty again and the next flush sends it whole.
+ * For updates without tearing, draw once LCDFB_IsBusy() returns 0.
+ *
+ * \return Command's result, LCD_FB_OPER_BUSY if the previous flush is still running
+ */
+unsigned int LCDFB_Flush(void);
+
+/**
+ * \return 1 while a flush is running
+ */
+unsigned int LCDFB_IsBusy(void);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __LCD_FB_H__ */
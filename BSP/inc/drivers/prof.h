@@ -0,0 +1,126 @@
+/**
+ * @file     prof.h
+ * @brief    Headers for the cycle profiler
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#include <stdint.h>
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup PROF Cycle profiler
+ *
+ * Measures code sections in core cycles, from the DWT cycle counter. Each section is a site,
+ * named after its tag, with its count, min, max, mean and a histogram of the durations in
+ * powers of two, kept in a fixed table filled as sites are first reached:
+ *
+ *     PROF_BEGIN(ethRx);
+ *     ...
+ *     PROF_END(ethRx);
+ *
+ * Off target the cycles are those of the host: rdtsc on x86, else clock_gettime() in ns.
+ * Off by default, the macros are then empty: define PROF_ENABLED to 1 in the project to
+ * measure.
+ * @{
+ */
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED                        0
+#endif
+#ifndef PROF_MAX_SITES
+#define PROF_MAX_SITES                      8
+#endif
+#define PROF_HIST_BINS                      32                  // Bin n: 2^n to 2^(n+1) - 1 cycles
+#define PROF_NO_SITE                        0xFF
+
+#if defined(__ICCARM__) || defined(__arm__)
+#include "LPC17xx.h"
+#define PROF_CYCLES()                       (DWT->CYCCNT)
+#elif defined(__x86_64__) || defined(__i386__)
+#define PROF_CYCLES()                       ((uint32_t)__builtin_ia32_rdtsc())
+#else
+#include <time.h>
+static inline uint32_t prof_host_cycles(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000 + now.tv_nsec);
+}
+#define PROF_CYCLES()                       prof_host_cycles()
+#endif
+
+#if PROF_ENABLED
+#define PROF_BEGIN(tag)                     static unsigned char tag##ProfSite = PROF_NO_SITE; uint32_t tag##ProfStart = PROF_CYCLES()
+#define PROF_END(tag)                       PROF_Record(&tag##ProfSite, #tag, PROF_CYCLES() - tag##ProfStart)
+#else
+#define PROF_BEGIN(tag)
+#define PROF_END(tag)
+#endif
+
+/// Statistics of a site
+typedef struct prof_site_t {
+    const char *name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t hist[PROF_HIST_BINS];
+} prof_site;
+
+/// Receives the dump, one line at a time, without the end of line
+typedef void (*prof_output)(const char *line, void *ctx);
+
+/**
+ * Starts the cycle counter. Sites and their statistics are kept, see PROF_Reset().
+ */
+void PROF_Init(void);
+
+/**
+ * Adds a measurement to a site. Callable from interrupts. Used by PROF_END().
+ *
+ * \param site Site index, looked up, or taken, on the first call if PROF_NO_SITE
+ * \param name Site name
+ * \param cycles Measured, the cost of the measure itself is taken off
+ */
+void PROF_Record(unsigned char *site, const char *name, uint32_t cycles);
+
+/**
+ * \return Sites in use
+ */
+unsigned int PROF_SiteCount(void);
+
+/**
+ * \param index 0 to PROF_SiteCount() - 1
+ * \return The site, 0 if none
+ */
+const prof_site *PROF_GetSite(unsigned int index);
+
+/**
+ * Clears the statistics, the sites stay
+ */
+void PROF_Reset(void);
+
+/**
+ * Writes the table as text: per site its name, count, min, mean, max, then the non-empty
+ * histogram bins as "2^n:count"
+ *
+ * \param output Line receiver
+ * \param ctx For the receiver
+ */
+void PROF_Dump(prof_output output, void *ctx);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __PROF_H__ */
@@ -0,0 +1,124 @@
+/**
+ * @file     sched.h
+ * @brief    Headers for the cooperative scheduler
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include <stdint.h>
+
+#include "swtimer.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup SCHED Cooperative scheduler
+ *
+ * Run-to-completion tasks: a task is a handler called with the event flags posted to it
+ * since its last run. Ready tasks wait in one FIFO per priority; the highest priority runs
+ * first. A handler that has to wait (DelayPort(), YieldPort(), SCHED_Delay()) lets the other
+ * ready tasks run meanwhile, nested on its stack; a task never runs nested in itself. With
+ * nothing ready the core sleeps.
+ * @{
+ */
+
+#define SCHED_PRIORITIES                    8                   // 0 is the lowest
+
+/* Result Codes */
+#define SCHED_OPER_SUCCESS                  0
+#define SCHED_OPER_FAIL                     1
+
+typedef struct sched_task_t sched_task;
+
+/// Runs the task, 'events' being the flags posted since its last run
+typedef void (*sched_handler)(sched_task *task, uint32_t events);
+
+/// A task. Owned by the caller, it must stay valid once added.
+struct sched_task_t {
+    sched_task *next;
+    sched_handler handler;
+    void *ctx;
+    volatile uint32_t events;               //!< Posted, not handled yet
+    uint32_t timerEvents;                   //!< Posted by 'timer'
+    swtimer timer;                          //!< Timed posts
+    unsigned char priority;
+    unsigned char queued;
+    unsigned char running;
+};
+
+/**
+ * SWTIMER_Init() must have been called
+ */
+void SCHED_Init(void);
+
+/**
+ * Adds a task, idle until something is posted to it
+ *
+ * \param task Task
+ * \param handler Task's handler
+ * \param ctx For the handler, in task->ctx
+ * \param priority 0 to SCHED_PRIORITIES - 1
+ * \return Command's result, SCHED_OPER_FAIL for a priority out of range
+ */
+unsigned int SCHED_AddTask(sched_task *task, sched_handler handler, void *ctx, unsigned int priority);
+
+/**
+ * Posts event flags to a task and makes it ready. Callable from interrupts.
+ *
+ * \param task Task
+ * \param events Flags, ORed with those pending
+ */
+void SCHED_Post(sched_task *task, uint32_t events);
+
+/**
+ * Posts event flags to a task after a delay. A task has one timed post at a time: a new one
+ * replaces the pending one.
+ *
+ * \param task Task
+ * \param events Flags
+ * \param delayUs Delay
+ */
+void SCHED_PostIn(sched_task *task, uint32_t events, uint32_t delayUs);
+
+/**
+ * Cancels the pending timed post of a task
+ */
+void SCHED_CancelPost(sched_task *task);
+
+/**
+ * Runs the highest priority ready task, if any
+ *
+ * \return 1 if a task ran
+ */
+unsigned int SCHED_RunOnce(void);
+
+/**
+ * Runs the tasks for ever, sleeping when none is ready
+ */
+void SCHED_Run(void);
+
+/**
+ * Runs the tasks that are ready now, then returns
+ */
+void SCHED_Yield(void);
+
+/**
+ * Waits, running the ready tasks and sleeping when none is
+ *
+ * \param ms Milliseconds
+ */
+void SCHED_Delay(unsigned int ms);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __SCHED_H__ */
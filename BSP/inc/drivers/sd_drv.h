@@ -0,0 +1,134 @@
+/**
+ * @file     sd_drv.h
+ * @brief    SD/MMC card over SPI headers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __SD_DRV_H__
+#define __SD_DRV_H__
+
+#include <stdint.h>
+
+#include "spi_bus.h"
+#include "blockdev.h"
+#include "gpio_drv.h"
+#include "board.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+ /** @defgroup SD SD card driver
+ * @{
+ */
+
+/* Wiring: SSP1 and the MMC socket pins of board.h on the IAR LPC-1768-SK */
+#ifndef SD_SSP_PORT
+#define SD_SSP_PORT                         SSP_PORT1
+#endif
+#ifndef SD_CS_PORT
+#define SD_CS_PORT                          BOARD_PORT(MMC_CS_FDIR)             // P0.6
+#define SD_CS_PIN                           BOARD_PIN(MMC_CS_MASK)
+#endif
+#define SD_PWR_PORT                         BOARD_PORT(MMC_PWR_FDIR)            // P0.21, low powers the socket
+#define SD_CP_PORT                          BOARD_PORT(MMC_CP_FDIR)             // P1.28, low with a card in
+#define SD_WP_PORT                          BOARD_PORT(MMC_WP_FDIR)             // P1.29, high on a write protected card
+
+#define SD_POWER_UP_MS                      10                  // Supply ramp before the first clocks
+
+#define SD_INIT_FREQUENCY                   400000              // Hz, identification mode
+#ifndef SD_FREQUENCY
+#define SD_FREQUENCY                        25000000            // Hz, data transfer mode
+#endif
+
+/* CRC on commands and data blocks. Off, the card only checks CMD0 and CMD8 */
+#ifndef SD_USE_CRC
+#define SD_USE_CRC                          0
+#endif
+
+#define SD_BLOCK_SIZE                       512
+
+/* Timeouts */
+#define SD_CMD_TIMEOUT                      8                   // Ncr, bytes clocked before the response
+#define SD_INIT_TIMEOUT                     1000                // ms, ACMD41 initialization
+#define SD_READ_TIMEOUT                     100                 // ms, start block token
+#define SD_WRITE_TIMEOUT                    500                 // ms, busy after a write
+
+/* Card types */
+#define SD_TYPE_NONE                        0
+#define SD_TYPE_MMC                         1
+#define SD_TYPE_SD1                         2
+#define SD_TYPE_SD2                         3                   // Byte addressed SDSC v2
+#define SD_TYPE_SDHC                        4                   // Block addressed
+
+/* Result Codes */
+#define SD_OPER_SUCCESS                     0
+#define SD_OPER_FAIL                        1
+#define SD_OPER_TIMEOUT                     2
+#define SD_OPER_CRC_ERROR                   3
+#define SD_OPER_NO_CARD                     4
+#define SD_OPER_WRITE_PROTECTED             5
+
+/**
+ * Powers the socket, then identifies the card and brings it to data transfer speed.
+ * SPIBUS_Init(SD_SSP_PORT) must have been called.
+ *
+ * \return Command's result, SD_OPER_NO_CARD at once with the socket empty
+ */
+unsigned int SD_Init(void);
+
+/**
+ * \return 1 if a card is in the socket, MMC_CP
+ */
+unsigned int SD_IsPresent(void);
+
+/**
+ * \return 1 if the card in the socket has its write protect tab set, MMC_WP
+ */
+unsigned int SD_IsWriteProtected(void);
+
+/**
+ * \return SD_TYPE_xxx, SD_TYPE_NONE until SD_Init() succeeds
+ */
+unsigned int SD_GetType(void);
+
+/**
+ * \return Card capacity in SD_BLOCK_SIZE blocks
+ */
+uint32_t SD_GetBlockCount(void);
+
+/**
+ * Reads consecutive blocks. Several blocks are streamed with a single command (CMD18).
+ *
+ * \param block First block
+ * \param dstAddr Destination buffer, DMA reachable
+ * \param count Number of blocks
+ * \return Command's result
+ */
+unsigned int SD_ReadBlocks(uint32_t block, void *dstAddr, unsigned int count);
+
+/**
+ * Writes consecutive blocks. Several blocks are streamed with a single command (CMD25),
+ * after telling the card how many to pre-erase (ACMD23).
+ *
+ * \param block First block
+ * \param srcAddr Source buffer, DMA reachable
+ * \param count Number of blocks
+ * \return Command's result, SD_OPER_WRITE_PROTECTED if the card is
+ */
+unsigned int SD_WriteBlocks(uint32_t block, const void *srcAddr, unsigned int count);
+
+/**
+ * \return The card as a generic block device, SD_BLOCK_SIZE aligned accesses
+ */
+const block_device *SD_GetBlockDevice(void);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __SD_DRV_H__ */
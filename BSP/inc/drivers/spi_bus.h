@@ -0,0 +1,142 @@
+/**
+ * @file     spi_bus.h
+ * @brief    Shared SPI bus headers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __SPI_BUS_H__
+#define __SPI_BUS_H__
+
+#include <stdint.h>
+
+#include "ssp_drv.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+ /** @defgroup SPI_BUS Shared SPI bus
+ * @{
+ */
+
+#ifndef SPIBUS_DMA_THRESHOLD
+#define SPIBUS_DMA_THRESHOLD                16                  //!< SPIBUS_Exchange() uses DMA from this many frames on
+#endif
+
+// Transaction flags
+#define SPIBUS_KEEP_CS                      (0x1)               //!< Leave CS asserted if the next queued transaction is for the same device
+
+// Result Codes
+#define SPIBUS_OPER_SUCCESS                 0
+#define SPIBUS_OPER_FAIL                    1
+#define SPIBUS_OPER_PENDING                 2
+
+/// A device on a bus. The settings are filled in by the caller before SPIBUS_AddDevice()
+typedef struct spi_bus_device_t {
+    unsigned char port;                     //!< SSP_PORTx
+    unsigned char csPort;                   //!< GPIO port of the chip select, active low
+    unsigned char csPin;
+    unsigned char mode;                     //!< SSP_MODE_x
+    unsigned char bitData;                  //!< Bits per frame, 4 to 16
+    unsigned int frequency;                 //!< Highest bit rate, Hz
+    unsigned int csSetupNs;                 //!< From CS asserted to the first clock edge
+    unsigned int csHoldNs;                  //!< From the last clock edge to CS released
+
+    // Computed by SPIBUS_AddDevice()
+    unsigned int rate;                      //!< Bit rate achieved, Hz
+    uint32_t cpsr;
+    uint32_t cr0;
+    LPC_GPIO_TypeDef *csGpio;
+    uint32_t csMask;
+    unsigned int csSetupLoops;
+    unsigned int csHoldLoops;
+} spi_bus_device;
+
+typedef struct spi_transaction_t spi_transaction;
+
+/// Called from the DMA interrupt when a queued transaction ends, once the next one is started
+typedef void (*spi_transaction_callback)(spi_transaction *transaction);
+
+/// Queued transfer. Buffers follow the SSP_TransferAsync() rules
+struct spi_transaction_t {
+    spi_bus_device *device;
+    const void *txBuffer;                   //!< 0 to send SSP_DUMMY_DATA
+    void *rxBuffer;                         //!< 0 to discard what is received
+    unsigned int length;                    //!< Frames
+    unsigned int flags;                     //!< SPIBUS_xxx
+    spi_transaction_callback callback;      //!< May be 0
+    void *ctx;
+    volatile unsigned int status;           //!< SPIBUS_OPER_xxx, pending while queued
+    spi_transaction *next;
+};
+
+/**
+ * Initializes an SSP port as a shared bus, at the PCLK selected by InitClock(). GPDMA_Init()
+ * must have been called.
+ *
+ * \param port SSP_PORTx
+ */
+void SPIBUS_Init(unsigned int port);
+
+/**
+ * Computes the register values of a device and configures its chip select as an output,
+ * released. The device must stay valid while the bus is in use.
+ *
+ * \param device Device with its settings filled in
+ * \return Command's result, fails if the bit rate cannot be reached or the frame width is not
+ * 4 to 16 bits
+ */
+unsigned int SPIBUS_AddDevice(spi_bus_device *device);
+
+/**
+ * Queues a transaction. Transactions run back to back on DMA, the SSP being reconfigured and
+ * the chip select toggled only when the device changes.
+ *
+ * \param transaction Transaction, must stay valid until it completes
+ * \return Command's result
+ */
+unsigned int SPIBUS_Submit(spi_transaction *transaction);
+
+/**
+ * Waits for a submitted transaction
+ *
+ * \param transaction Transaction
+ * \return Transaction's result
+ */
+unsigned int SPIBUS_Wait(spi_transaction *transaction);
+
+/**
+ * Takes the bus for a sequence of SPIBUS_Exchange() calls once the queue has drained, and
+ * asserts the chip select. Queued transactions resume on SPIBUS_Deselect().
+ *
+ * \param device Device
+ */
+void SPIBUS_Select(spi_bus_device *device);
+
+/**
+ * Transfers frames on a selected device, polled for short transfers and on DMA otherwise
+ *
+ * \param device Selected device
+ * \param txBuffer Data to be sent, 0 to send SSP_DUMMY_DATA
+ * \param rxBuffer Buffer for the received data, 0 to discard it
+ * \param length Number of frames
+ * \return Command's result
+ */
+unsigned int SPIBUS_Exchange(spi_bus_device *device, const void *txBuffer, void *rxBuffer, unsigned int length);
+
+/**
+ * Releases the chip select and the bus taken by SPIBUS_Select()
+ *
+ * \param device Selected device
+ */
+void SPIBUS_Deselect(spi_bus_device *device);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __SPI_BUS_H__ */
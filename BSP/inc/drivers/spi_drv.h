@@ -30,8 +30,21 @@
 
 
 #define PCONP_SPI_BIT_SHIFT                 (0x8)
-//BIT_TRANSFER_RATE_MASK    (0x0004)
-#define SPCCR_MASK                          (0x93C)
+// SPCR
+#define SPCR_BIT_ENABLE                     (0x1 << 2)          //!< Frame width set by SPCR_BITS, 8 bits otherwise
+#define SPCR_CPHA                           (0x1 << 3)
+#define SPCR_CPOL                           (0x1 << 4)
+#define SPCR_MSTR                           (0x1 << 5)
+#define SPCR_BITS_SHIFT                     (8)
+#define SPCR_BITS_MASK                      (0xF << SPCR_BITS_SHIFT)
+#define SPCR_BITS(bits)                     (((bits) & 0xF) << SPCR_BITS_SHIFT)     //!< 8 to 16, 16 encodes as 0
+#define SPCR_MODE_MASK                      (SPCR_MSTR | SPCR_CPOL | SPCR_CPHA)     //!< Master, mode 3
+
+#define SPI_MIN_BITS                        8
+#define SPI_MAX_BITS                        16
+// SPCCR
+#define SPI_MIN_DIVIDER                     8
+#define SPI_MAX_DIVIDER                     254
 
 #define SPI_POWER_ON                        (LPC_SC->PCONP |= (0x1 << PCONP_SPI_BIT_SHIFT))
 #define SPI_POWER_OFF                       (LPC_SC->PCONP &= ~(0x1 << PCONP_SPI_BIT_SHIFT))
@@ -50,11 +63,46 @@ typedef struct spsr_register_t {
 } spsr_register;
 
 
-/** SPI init
-* \param frequency Transmission rate
-* \param bitData Number of bits per transmission
+/// Clock settings: bit rate = CCLK / CLOCK_MODE_DIVIDER(pclkMode) / divider
+typedef struct spi_clock_t {
+    unsigned int pclkMode;                  //!< CLOCK_MODE_xxx
+    unsigned int divider;                   //!< SPCCR, even, 8 to 254
+    unsigned int rate;                      //!< Resulting bit rate, Hz
+} spi_clock;
+
+/** Finds the PCLK selection and divider giving the fastest bit rate not above 'frequency'.
+ * When 'frequency' is below the slowest rate possible the slowest settings are returned.
+ * For choosing the PCLKSEL of InitClock(): SPI_Init() does not change it.
+ *
+ * \param cclk Core clock, Hz
+ * \param frequency Highest bit rate wanted, Hz
+ * \param clock Resulting settings
+ * \return The bit rate achieved, Hz
+ */
+unsigned int SPI_SolveClock(unsigned int cclk, unsigned int frequency, spi_clock *clock);
+
+/** Finds the divider giving the fastest bit rate not above 'frequency' for a given PCLK.
+ * 'pclkMode' is left untouched.
+ *
+ * \param pclk Peripheral clock, Hz
+ * \param frequency Highest bit rate wanted, Hz
+ * \param clock Resulting settings
+ * \return The bit rate achieved, Hz, 0 if 'frequency' is too low for this PCLK
+ */
+unsigned int SPI_SolveDivider(unsigned int pclk, unsigned int frequency, spi_clock *clock);
+
+/** SPI init. The bit rate is derived from the PCLK selected by InitClock(), PCLKSEL is not written.
+* \param frequency Highest bit rate, Hz
+* \param bitData Number of bits per transmission, 8 to 16
+* \return The bit rate achieved, Hz
 */
-void SPI_Init(int frequency, int bitData);
+unsigned int SPI_Init(int frequency, int bitData);
+
+/** Changes the frame width, between transfers
+ *
+ * \param bitData Number of bits per transmission, 8 to 16
+ */
+void SPI_SetFrameWidth(int bitData);
 
 /** Set the chip select of the slave device
  * 
@@ -77,6 +125,36 @@ void SPI_EndTransfer(int csBitId);
  */
 void SPI_Transfer(unsigned short *txBuffer, unsigned short *rxBuffer, int lenght);
 
+/** Transmits 'lenght' frames of up to 8 bits from a byte buffer
+ *
+ * \param txBuffer Data to be sent
+ * \param rxBuffer Buffer for the received data, 0 to discard it
+ * \param lenght Number of frames
+ */
+void SPI_TransferBytes(const unsigned char *txBuffer, unsigned char *rxBuffer, int lenght);
+
+/** Transmits 'lenght' frames, ignoring what is received
+ *
+ * \param txBuffer Data to be sent
+ * \param lenght Number of frames
+ */
+void SPI_Write(const unsigned short *txBuffer, int lenght);
+
+/** Byte buffer version of SPI_Write()
+ *
+ * \param txBuffer Data to be sent
+ * \param lenght Number of frames
+ */
+void SPI_WriteBytes(const unsigned char *txBuffer, int lenght);
+
+/** Receives 'lenght' frames of up to 8 bits, sending 'fill' for each of them
+ *
+ * \param rxBuffer Buffer for the received data
+ * \param lenght Number of frames
+ * \param fill Value sent while receiving, usually 0xFF
+ */
+void SPI_ReadBytes(unsigned char *rxBuffer, int lenght, unsigned char fill);
+
 
 /**
  * @}
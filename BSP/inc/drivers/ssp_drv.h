@@ -0,0 +1,188 @@
+/**
+ * @file     ssp_drv.h
+ * @brief    SSP headers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __SSP_DRV_H__
+#define __SSP_DRV_H__
+
+#include <stdint.h>
+
+#include "gpio_drv.h"
+#include "gpdma_drv.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+ /** @defgroup SSP SSP Driver
+ * @{
+ */
+
+#define SSP_PORT0                           0                   //!< SCK0 P1.20, MISO0 P1.23, MOSI0 P1.24 (LCD)
+#define SSP_PORT1                           1                   //!< SCK1 P0.7, MISO1 P0.8, MOSI1 P0.9 (MMC/SD)
+#define SSP_PORTS                           2
+
+// SSP pins
+#define SSP0_SCK_SHIFT                      8                   //!< P1.20 PINSEL3
+#define SSP0_MISO_SHIFT                     14                  //!< P1.23 PINSEL3
+#define SSP0_MOSI_SHIFT                     16                  //!< P1.24 PINSEL3
+#define SSP1_SCK_SHIFT                      14                  //!< P0.7 PINSEL0
+#define SSP1_MISO_SHIFT                     16                  //!< P0.8 PINSEL0
+#define SSP1_MOSI_SHIFT                     18                  //!< P0.9 PINSEL0
+// Clock
+#define SSP0_CLOCK_MODE_SHIFT               10                  //!< PCLKSEL1
+#define SSP1_CLOCK_MODE_SHIFT               20                  //!< PCLKSEL0
+
+#define PCONP_SSP0_BIT_SHIFT                (21)
+#define PCONP_SSP1_BIT_SHIFT                (10)
+#define SET_SSP0_POWER_ON                   (LPC_SC->PCONP |= (0x1 << PCONP_SSP0_BIT_SHIFT))
+#define SET_SSP1_POWER_ON                   (LPC_SC->PCONP |= (0x1 << PCONP_SSP1_BIT_SHIFT))
+
+// CR0
+#define SSP_CR0_DSS(bits)                   ((bits) - 1)
+#define SSP_CR0_DSS_MASK                    (0xF)
+#define SSP_MIN_BITS                        4                   //!< Frame widths DSS can encode
+#define SSP_MAX_BITS                        16
+#define SSP_CR0_CPOL                        (0x1 << 6)
+#define SSP_CR0_CPHA                        (0x1 << 7)
+#define SSP_CR0_SCR(scr)                    ((scr) << 8)
+// CR1
+#define SSP_CR1_SSE                         (0x1 << 1)
+// SR
+#define SSP_SR_TFE                          (0x1 << 0)
+#define SSP_SR_TNF                          (0x1 << 1)
+#define SSP_SR_RNE                          (0x1 << 2)
+#define SSP_SR_BSY                          (0x1 << 4)
+// ICR
+#define SSP_ICR_RORIC                       (0x1 << 0)
+// DMACR
+#define SSP_DMACR_RXDMAE                    (0x1 << 0)
+#define SSP_DMACR_TXDMAE                    (0x1 << 1)
+
+#define SSP_FIFO_DEPTH                      8
+// Clock
+#define SSP_MIN_CPSR                        2
+#define SSP_MAX_CPSR                        254
+#define SSP_MAX_SCR                         255
+
+// Clock polarity and phase
+#define SSP_MODE_0                          (0x0)
+#define SSP_MODE_1                          (SSP_CR0_CPHA)
+#define SSP_MODE_2                          (SSP_CR0_CPOL)
+#define SSP_MODE_3                          (SSP_CR0_CPOL | SSP_CR0_CPHA)
+
+// DMA channels, receive first: it must win over transmit to avoid overruns
+#define SSP0_DMA_RX_CHANNEL                 0
+#define SSP0_DMA_TX_CHANNEL                 1
+#define SSP1_DMA_RX_CHANNEL                 2
+#define SSP1_DMA_TX_CHANNEL                 3
+
+#ifndef SSP_DMA_LLI_MAX
+#define SSP_DMA_LLI_MAX                     4                   //!< Linked list items per direction, GPDMA_MAX_TRANSFER frames each
+#endif
+
+#define SSP_DUMMY_DATA                      0xFFFF              //!< Sent when there is no transmit buffer
+
+// Result Codes
+#define SSP_OPER_SUCCESS                    0
+#define SSP_OPER_FAIL                       1
+
+/// Called from GPDMA_IRQHandler when an asynchronous transfer ends, 'status' is GPDMA_STATUS_xxx
+typedef void (*ssp_callback)(unsigned int port, unsigned int status, void *ctx);
+
+/// Clock settings: bit rate = CCLK / CLOCK_MODE_DIVIDER(pclkMode) / (cpsr * (scr + 1))
+typedef struct ssp_clock_t {
+    unsigned int pclkMode;                  //!< CLOCK_MODE_xxx
+    unsigned int cpsr;                      //!< Prescaler, even, 2 to 254
+    unsigned int scr;                       //!< Serial clock rate, 0 to 255
+    unsigned int rate;                      //!< Resulting bit rate, Hz
+} ssp_clock;
+
+/** Finds the PCLK selection, prescaler and serial clock rate giving the fastest bit rate not
+ * above 'frequency'. When 'frequency' is below the slowest rate possible the slowest settings
+ * are returned. For choosing the PCLKSEL of InitClock(): the drivers do not change it.
+ *
+ * \param cclk Core clock, Hz
+ * \param frequency Highest bit rate wanted, Hz
+ * \param clock Resulting settings
+ * \return The bit rate achieved, Hz
+ */
+unsigned int SSP_SolveClock(unsigned int cclk, unsigned int frequency, ssp_clock *clock);
+
+/** Finds the prescaler and serial clock rate giving the fastest bit rate not above 'frequency'
+ * for a given PCLK. 'pclkMode' is left untouched.
+ *
+ * \param pclk Peripheral clock, Hz
+ * \param frequency Highest bit rate wanted, Hz
+ * \param clock Resulting settings
+ * \return The bit rate achieved, Hz, 0 if 'frequency' is too low for this PCLK
+ */
+unsigned int SSP_SolveDivider(unsigned int pclk, unsigned int frequency, ssp_clock *clock);
+
+/**
+ * \param port SSP_PORTx
+ * \return PCLK of the port, Hz, as selected in PCLKSEL
+ */
+unsigned int SSP_GetPclk(unsigned int port);
+
+/** SSP init, master mode. GPDMA_Init() must be called before the asynchronous transfers are used.
+ * The bit rate is derived from the PCLK selected by InitClock(), PCLKSEL is not written.
+ *
+ * \param port SSP_PORTx
+ * \param frequency Highest bit rate, Hz
+ * \param bitData Number of bits per frame, 4 to 16
+ * \param mode SSP_MODE_x
+ * \return The bit rate achieved, Hz
+ */
+unsigned int SSP_Init(unsigned int port, unsigned int frequency, unsigned int bitData, unsigned int mode);
+
+/** Transmits 'length' frames, keeping the FIFO full. Frames are bytes when the frame width
+ * is up to 8 bits, half words otherwise.
+ *
+ * \param port SSP_PORTx
+ * \param txBuffer Data to be sent, 0 to send SSP_DUMMY_DATA
+ * \param rxBuffer Buffer for the received data, 0 to discard it
+ * \param length Number of frames
+ */
+void SSP_Transfer(unsigned int port, const void *txBuffer, void *rxBuffer, unsigned int length);
+
+/** Starts a DMA transfer and returns immediately. Buffers must be in DMA reachable RAM
+ * and stay valid until 'callback' runs.
+ *
+ * \param port SSP_PORTx
+ * \param txBuffer Data to be sent, 0 to send SSP_DUMMY_DATA
+ * \param rxBuffer Buffer for the received data, 0 to discard it
+ * \param length Number of frames, up to SSP_DMA_LLI_MAX * GPDMA_MAX_TRANSFER
+ * \param callback Completion callback, may be 0
+ * \param ctx Passed to 'callback'
+ * \return Command's result, fails if a transfer is running or 'length' is too long
+ */
+unsigned int SSP_TransferAsync(unsigned int port, const void *txBuffer, void *rxBuffer, unsigned int length,
+                               ssp_callback callback, void *ctx);
+
+/** Loads a frame format and bit rate, waiting for the current frame to end. PCLK is not changed:
+ * on the LPC17xx PCLKSEL may not take effect once PLL0 is connected (errata PCLKSELx.1).
+ *
+ * \param port SSP_PORTx
+ * \param cpsr Prescaler
+ * \param cr0 SSP_CR0_DSS() | SSP_MODE_x | SSP_CR0_SCR()
+ */
+void SSP_SetFormat(unsigned int port, uint32_t cpsr, uint32_t cr0);
+
+/**
+ * \param port SSP_PORTx
+ * \return 1 while an asynchronous transfer is running
+ */
+unsigned int SSP_IsBusy(unsigned int port);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __SSP_DRV_H__ */
@@ -0,0 +1,116 @@
+/**
+ * @file     stack.h
+ * @brief    Headers for the main stack monitor
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __STACK_H__
+#define __STACK_H__
+
+#include <stdint.h>
+
+#include "LPC17xx.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup STACK Main stack monitor
+ *
+ * Watches CSTACK, the stack of main() and of every handler. STACK_Init() fills the free part
+ * with STACK_PAINT; the deepest word no longer painted is the high-water mark, the most the
+ * stack has ever held. To size a single path, repaint first:
+ *
+ *     STACK_Paint();
+ *     ETH_Init();
+ *     depth = STACK_GetHighWater();
+ *
+ * The lowest STACK_GUARD_SIZE bytes of CSTACK are an MPU region that nothing may access: an
+ * overflow traps in MemManage_Handler, instead of silently overwriting what lies below. The
+ * handler switches back to the top of the stack, records the fault where startup does not
+ * initialize, and resets; STACK_GetFault() returns it after the reset. Kernel threads run
+ * on their own stacks and are not covered.
+ * @{
+ */
+
+#ifndef STACK_GUARD_ENABLED
+#define STACK_GUARD_ENABLED                 1
+#endif
+#define STACK_GUARD_SIZE                    32                  // MPU minimum; CSTACK is aligned on it in the ICF
+#define STACK_PAINT                         0xDEADBEEF
+#define STACK_PAINT_MARGIN                  64                  // Left unpainted below the caller's stack pointer
+#define STACK_FAULT_MAGIC                   0x5354434B          // "STCK"
+
+/* Result Codes */
+#define STACK_OPER_SUCCESS                  0
+#define STACK_OPER_FAIL                     1
+
+/// A memory management fault, as recorded by MemManage_Handler
+typedef struct stack_fault_t {
+    uint32_t magic;                         //!< STACK_FAULT_MAGIC when the record is valid
+    uint32_t sp;                            //!< Stack pointer the fault left
+    uint32_t pc;                            //!< Faulting instruction, 0 if it could not be stacked
+    uint32_t address;                       //!< SCB->MMFAR, 0 if not valid
+    uint32_t status;                        //!< SCB->CFSR memory management bits
+    uint8_t overflow;                       //!< 1 if the main stack ran into the guard
+} stack_fault;
+
+/// Receives the report, one line at a time, without the end of line
+typedef void (*stack_output)(const char *line, void *ctx);
+
+/**
+ * Takes over the fault recorded before the reset, if any, paints the stack, sets up the guard
+ * and enables the memory management fault. First in main(), before the interrupts are enabled.
+ */
+void STACK_Init(void);
+
+/**
+ * Paints the free stack again, below the caller, so that the next high-water mark is the
+ * depth of what follows
+ */
+void STACK_Paint(void);
+
+/**
+ * \return Bytes of CSTACK used at most since painted, the guard not included
+ */
+unsigned int STACK_GetHighWater(void);
+
+/**
+ * \return Bytes of CSTACK, the guard not included
+ */
+unsigned int STACK_GetSize(void);
+
+/**
+ * \param fault Receives the fault recorded just before the last reset; a later reset, with no
+ * fault, clears it
+ * \return STACK_OPER_SUCCESS if there was one, else STACK_OPER_FAIL
+ */
+unsigned int STACK_GetFault(stack_fault *fault);
+
+/**
+ * Writes the stack size, the high-water mark, the margin left and the fault recorded before
+ * the last reset, if any
+ *
+ * \param output Receiver
+ * \param ctx For the receiver
+ */
+void STACK_Report(stack_output output, void *ctx);
+
+/**
+ * Called by MemManage_Handler, once on the top of the stack again; does not return
+ *
+ * \param sp Stack pointer the fault left
+ * \param excReturn EXC_RETURN value of the fault
+ */
+void STACK_Fault(uint32_t sp, uint32_t excReturn);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __STACK_H__ */
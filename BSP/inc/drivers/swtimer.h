@@ -0,0 +1,106 @@
+/**
+ * @file     swtimer.h
+ * @brief    Headers for the software timers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __SWTIMER_H__
+#define __SWTIMER_H__
+
+#include <stdint.h>
+
+#include "timer_drv.h"
+
+/** @addtogroup DRIVERS
+* @{
+*/
+
+ /** @defgroup SWTIMER Software timers
+ *
+ * Any number of timers on the TIMER0 time base. They are kept in a hierarchical wheel:
+ * SWTIMER_LEVELS levels of 64 slots, each level 64 times coarser than the one below, and
+ * a bitmap per level of the slots in use. Starting and stopping a timer is O(1); a timer
+ * in an upper level is moved down when its slot comes up. There is no periodic tick: the
+ * MR0 match is armed for the next expiry or move only.
+ * @{
+ */
+
+#define SWTIMER_MATCH_CHANNEL               0                   // TIMER0 MR0
+#ifndef SWTIMER_UNIT_SHIFT
+#define SWTIMER_UNIT_SHIFT                  10                  // Resolution: 2^10 ticks, ~41 us at 25 MHz
+#endif
+#define SWTIMER_LEVELS                      4                   // Span: 2^24 units, ~11 min at 25 MHz
+#define SWTIMER_SLOT_BITS                   6
+#define SWTIMER_SLOTS                       (0x1 << SWTIMER_SLOT_BITS)
+
+typedef struct swtimer_t swtimer;
+
+/// Called from the TIMER0 interrupt. The timer may be started again or stopped from here.
+typedef void (*swtimer_callback)(swtimer *timer, void *ctx);
+
+/// A timer. Owned by the caller, it must stay valid while started.
+struct swtimer_t {
+    swtimer *next;
+    swtimer *prev;
+    uint64_t expires;                       //!< Units since TIMER0_Init()
+    uint32_t period;                        //!< Units, 0 for a one-shot timer
+    swtimer_callback callback;
+    void *ctx;
+    unsigned char level;
+    unsigned char slot;
+    unsigned char active;
+};
+
+/**
+ * Takes the SWTIMER_MATCH_CHANNEL match of TIMER0. TIMER0_Init() must have been called.
+ */
+void SWTIMER_Init(void);
+
+/**
+ * Prepares a timer, stopped
+ *
+ * \param timer Timer
+ * \param callback Called on expiry
+ * \param ctx Passed to the callback
+ */
+void SWTIMER_Setup(swtimer *timer, swtimer_callback callback, void *ctx);
+
+/**
+ * Starts, or restarts, a timer. It never expires early; it may expire up to one unit late.
+ *
+ * \param timer Timer set up by SWTIMER_Setup()
+ * \param delayUs From now to the first expiry
+ * \param periodUs Then between expiries, 0 for once
+ */
+void SWTIMER_Start(swtimer *timer, uint32_t delayUs, uint32_t periodUs);
+
+/**
+ * Starts, or restarts, a one-shot timer on an absolute time
+ *
+ * \param timer Timer set up by SWTIMER_Setup()
+ * \param ticks Time base value, TIMER0_GetTicks64(), to expire at or after
+ */
+void SWTIMER_StartAt(swtimer *timer, uint64_t ticks);
+
+/**
+ * Stops a timer; nothing happens if it is not started
+ *
+ * \param timer Timer
+ */
+void SWTIMER_Stop(swtimer *timer);
+
+/**
+ * \return 1 if the timer is started
+ */
+unsigned int SWTIMER_IsActive(const swtimer *timer);
+
+/**
+ * @}
+ */
+ /**
+ * @}
+ */
+
+#endif /* __SWTIMER_H__ */
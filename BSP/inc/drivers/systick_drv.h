@@ -26,10 +26,18 @@
 
 #define SYSTICK_SET_RELOAD_VALUE(value)             SysTick->LOAD = ((SysTick->LOAD & (~SysTick_LOAD_RELOAD_Msk)) | (value) << SysTick_LOAD_RELOAD_Pos)
 
+/// Called from SysTick_Handler on every tick
+typedef void (*systick_callback)(void);
+
 void SYSTICK_Init(unsigned value);
 unsigned int SYSTICK_Read();
 void SYSTICK_Set(unsigned int value);
 
+/**
+ * \param callback Called on every tick, 0 for none
+ */
+void SYSTICK_SetCallback(systick_callback callback);
+
 #endif /* DRIVERS_SYSTICK_DRV_H_ */
 
 /**
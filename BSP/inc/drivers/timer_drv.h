@@ -10,6 +10,8 @@
 #ifndef __TIMER_H__
 #define __TIMER_H__
 
+#include <stdint.h>
+
 #include "LPC17xx.h"
 
  /** @addtogroup DRIVERS
@@ -33,6 +35,36 @@
 // Clock mode
 #define TIMER0_CLOCK_MODE_SHIFT         (0x2)
 #define TIMER1_CLOCK_MODE_SHIFT         (0x4)
+// Match control: MRx interrupt, reset and stop bits
+#define MCR_MRI(channel)                (0x1 << (3 * (channel)))
+#define MCR_MRR(channel)                (0x2 << (3 * (channel)))
+#define MCR_MRS(channel)                (0x4 << (3 * (channel)))
+#define IR_MR(channel)                  (0x1 << (channel))
+
+// Time base: TIMER0 runs free and MR3 extends it to 64 bits
+#ifndef TIMER_PCLK_HZ
+#define TIMER_PCLK_HZ                   25000000    //!< CCLK / 4, PCLKSEL0 as set by InitClock() before PLL0 is connected (erratum PCLKSELx.1)
+#endif
+#ifndef TIMER_PRESCALER
+#define TIMER_PRESCALER                 1
+#endif
+#define TIMER_TICK_HZ                   (TIMER_PCLK_HZ / TIMER_PRESCALER)
+#define TIMER_TICKS_PER_US              (TIMER_TICK_HZ / 1000000)
+#if (TIMER_TICK_HZ % 1000000) != 0
+#error "TIMER_TICK_HZ must be a whole number of MHz"
+#endif
+// Conversions, scaled at compile time from TIMER_TICK_HZ. 'ticks' is unsigned, the ms and us
+// ones must not overflow 32 bits once converted (~171 s).
+#define TicksToUS(ticks)                ((ticks) / TIMER_TICKS_PER_US)
+#define TicksToMS(ticks)                ((ticks) / (TIMER_TICK_HZ / 1000))
+#define USToTicks(us)                   ((unsigned int)(us) * TIMER_TICKS_PER_US)
+#define MSToTicks(ms)                   ((unsigned int)(ms) * (TIMER_TICK_HZ / 1000))
+#define TIMER_MAX_SPAN_MS               (0x7FFFFFFFUL / (TIMER_TICK_HZ / 1000))  //!< Longest timer_deadline() span, ~85 s
+
+#define TIMER_MATCH_CHANNELS            3           //!< MR0 to MR2 are free for TIMER0_SetMatch()
+#define TIMER_SLEEP_CHANNEL             1           //!< MR1 wakes TIMER0_SleepUntil()
+#define TIMER_MIN_LEAD                  32          //!< Ticks: a match set closer than this might be missed
+#define TIMER_WRAP_CHANNEL              3
 
 
 // Power
@@ -54,12 +86,13 @@
 #define SET_TIMER1_MODE(mode)           (LPC_TIM1->CTCR = (LPC_TIM1->CTCR & ~(CTCR_MODE_MASK)) | ((mode) << (CTCR_MODE_BITS_SHIFT)))
 
 
+/// Called from the TIMER0 interrupt when a match set by TIMER0_SetMatch() occurs
+typedef void (*timer_match_callback)(unsigned int channel);
+
 /** 
- * Timer 0 init
- * 
- * \param frequency Frequency to be configured
+ * Timer 0 init: free running at TIMER_TICK_HZ, extended to 64 bits by its wrap interrupt
 */
-void TIMER0_Init(unsigned int frequency);
+void TIMER0_Init(void);
 
 /** 
  * \return Returns the current value of Timer 0 in ticks
@@ -70,10 +103,93 @@ unsigned int TIMER0_GetValue(void);
  * Calculates the different between the current Timer 0 value and the given 'lastRead' 
  *
  * \param lastRead Last read value
- * \return Returns the different between the current Timer 0 value and the given 'lastRead'
+ * \return Returns the different between the current Timer 0 value and the given 'lastRead',
+ * correct across one wrap of the counter
 * */
 unsigned int TIMER0_Elapse(unsigned int lastRead);
 
+/**
+ * \return Low 32 bits of the time base, for timer_elapsed_ticks() and timer_deadline()
+ */
+unsigned int timer_get_ticks(void);
+
+/**
+ * \param start Value from timer_get_ticks()
+ * \return Ticks since 'start', correct across one wrap of the counter (~171 s)
+ */
+unsigned int timer_elapsed_ticks(unsigned int start);
+
+/**
+ * \param ticks From now, up to MSToTicks(TIMER_MAX_SPAN_MS)
+ * \return Deadline for timer_expired()
+ */
+unsigned int timer_deadline(unsigned int ticks);
+
+/**
+ * \param deadline Value from timer_deadline()
+ * \return 1 once the deadline is reached, whether the counter wrapped or not in between
+ */
+int timer_expired(unsigned int deadline);
+
+/**
+ * Monotonic time, lock free: callable from any interrupt and with interrupts masked
+ *
+ * \return Ticks since TIMER0_Init(), TIMER_TICK_HZ
+ */
+uint64_t TIMER0_GetTicks64(void);
+
+/**
+ * \return Microseconds since TIMER0_Init()
+ */
+uint64_t TIMER0_GetMicros(void);
+
+/**
+ * Arms a match interrupt. The callback runs once, it may arm the channel again.
+ *
+ * \param channel 0 to TIMER_MATCH_CHANNELS - 1
+ * \param ticks Low 32 bits of the time to match
+ * \param callback Called from the TIMER0 interrupt
+ */
+void TIMER0_SetMatch(unsigned int channel, uint32_t ticks, timer_match_callback callback);
+
+/**
+ * Disarms a match interrupt
+ *
+ * \param channel 0 to TIMER_MATCH_CHANNELS - 1
+ */
+void TIMER0_ClearMatch(unsigned int channel);
+
+/**
+ * Sleeps (WFI) until the time base reaches 'ticks', waking on the TIMER_SLEEP_CHANNEL match.
+ * Other interrupts are served meanwhile. Thread mode only: from an interrupt that outranks
+ * TIMER0 the match could not wake the core.
+ *
+ * \param ticks Time base value, TIMER0_GetTicks64()
+ */
+void TIMER0_SleepUntil(uint64_t ticks);
+
+/**
+ * One step of a sleep: arms the TIMER_SLEEP_CHANNEL match on 'ticks' and executes WFI, to
+ * return on the match or on any other interrupt. Call it with interrupts masked, after
+ * checking whatever the wait is for; pending interrupts run once they are unmasked.
+ *
+ * \param ticks Time base value, TIMER0_GetTicks64(). Returns at once if already reached.
+ */
+void TIMER0_WaitForInterrupt(uint64_t ticks);
+
+/**
+ * Sleeps for 'us' microseconds, see TIMER0_SleepUntil()
+ */
+void TIMER0_SleepUs(uint32_t us);
+
+/**
+ * Busy waits on the core cycle counter (DWT CYCCNT), for waits too short to sleep through.
+ * Callable from anywhere.
+ *
+ * \param us Microseconds, below 2^32 core cycles (~42 s at 100 MHz)
+ */
+void TIMER0_DelayUs(uint32_t us);
+
 /**
  * @}
  */
@@ -13,37 +13,32 @@
 //#define DEBUG_ETH
 
 static eth_addr mAddr;
+static volatile unsigned int linkUp;        //!< As last read from the PHY, by ETH_Init() or ETH_isUp()
 
 extern void DelayPort(unsigned int ms);
 extern void YieldPort(void);
 
 
 static void WriteToPHY(int reg, int writeval) {
-    unsigned int loop;
+    unsigned int deadline;
     // Set up address to access in MII Mgmt Address Register
     LPC_EMAC->MADR = (PHY_DEF_ADR << PHY_DEF_ADR_SHIFT) | reg;
     // Write value into MII Mgmt Write Data Register
     LPC_EMAC->MWTD = writeval;
     // Loop whilst write to PHY completes
-    for (loop = 0; loop < MII_WR_TOUT; loop++) {
-        if ((LPC_EMAC->MIND & MIND_BUSY) == 0) {
-            break;
-        }
-    }
+    deadline = timer_deadline(MSToTicks(MII_WR_TOUT));
+    while((LPC_EMAC->MIND & MIND_BUSY) && !timer_expired(deadline));
 }
 
 static unsigned short ReadFromPHY(unsigned char reg) {
-    unsigned int loop;
+    unsigned int deadline;
     // Set up address to access in MII Mgmt Address Register
     LPC_EMAC->MADR = (PHY_DEF_ADR << PHY_DEF_ADR_SHIFT) | reg;
     // Trigger a PHY read via MIIMgmt Command Register
     LPC_EMAC->MCMD = MCMD_READ;
     // Loop whilst read from PHY completes
-    for (loop = 0; loop < MII_RD_TOUT; loop++) {
-        if ((LPC_EMAC->MIND & MIND_BUSY) == 0)  {
-            break;
-        }
-    }
+    deadline = timer_deadline(MSToTicks(MII_RD_TOUT));
+    while((LPC_EMAC->MIND & MIND_BUSY) && !timer_expired(deadline));
     LPC_EMAC->MCMD = 0;
     // Cancel read
     // Returned value is in MIIMgmt Read Data Register
@@ -63,19 +58,50 @@ static void ETH_Reset(void) {
                         0x1 << 5;   // RxReset
 }
 
-static void update_consume_idx(void) {
+RAMFUNC static void update_consume_idx(void) {
     unsigned int idx = LPC_EMAC->RxConsumeIndex;
     LPC_EMAC->RxConsumeIndex = (++idx) % NUM_RX_FRAG;
 }
 
-static void update_produce_idx(void) {
+RAMFUNC static void update_produce_idx(void) {
     unsigned int idx = LPC_EMAC->TxProduceIndex;
     LPC_EMAC->TxProduceIndex = (++idx) % NUM_TX_FRAG;
 }
 
+/**
+ * memcpy() of the library is in flash: the frame paths copy with this one. Four words at a
+ * time, for LDM/STM, when both buffers are aligned, as the EMAC buffers are.
+ */
+RAMFUNC static void frame_copy(void *dst, const void *src, unsigned int len) {
+    uint8_t *dstByte = (uint8_t *)dst;
+    const uint8_t *srcByte = (const uint8_t *)src;
+    uint32_t *dstWord;
+    const uint32_t *srcWord;
+
+    if(!(((uintptr_t)dst | (uintptr_t)src) & 0x3)) {
+        dstWord = (uint32_t *)dst;
+        srcWord = (const uint32_t *)src;
+        for(; len >= 16; len -= 16, dstWord += 4, srcWord += 4) {
+            dstWord[0] = srcWord[0];
+            dstWord[1] = srcWord[1];
+            dstWord[2] = srcWord[2];
+            dstWord[3] = srcWord[3];
+        }
+        for(; len >= 4; len -= 4) {
+            *dstWord++ = *srcWord++;
+        }
+        dstByte = (uint8_t *)dstWord;
+        srcByte = (const uint8_t *)srcWord;
+    }
+    while(len--) {
+        *dstByte++ = *srcByte++;
+    }
+}
+
 
 
 int ETH_Init(eth_addr *macAddr) {
+    linkUp = 0;
     // Power On
     SET_ETH_POWER_ON;
     // Pin function
@@ -246,6 +272,7 @@ int ETH_Init(eth_addr *macAddr) {
     /********   Enable Rx/TxPaths   ********/
     LPC_EMAC->Command |= 0x3;
     LPC_EMAC->MAC1 |= 0x1;
+    linkUp = 1;
 
     // init OK
     return INIT_OK;
@@ -256,21 +283,22 @@ unsigned int ETH_isUp(void) {
     unsigned short link = (PHY_LINK_UP(regData) >> PHY_R1_LINK_STAT_SHIFT);
     unsigned short autoNeg = (PHY_AUTONEGOTIATION_DONE(regData) >> PHY_R1_ATNEGOTIATION_DONE_SHIFT);
 
-    return (link & autoNeg);
+    linkUp = link & autoNeg;
+    return linkUp;
 }
 
-unsigned int ETH_Data_Received() {
+RAMFUNC unsigned int ETH_Data_Received() {
     return LPC_EMAC->RxConsumeIndex != LPC_EMAC->RxProduceIndex;
 }
 
-unsigned int ETH_Data_Full() {
+RAMFUNC unsigned int ETH_Data_Full() {
     return (LPC_EMAC->TxProduceIndex == LPC_EMAC->TxConsumeIndex - 1)
             || (LPC_EMAC->TxProduceIndex - LPC_EMAC->TxConsumeIndex == NUM_TX_FRAG - 1);
 }
 
-unsigned int ETH_Receive_Frame(void *dst, unsigned int len) {
+RAMFUNC unsigned int ETH_Receive_Frame(void *dst, unsigned int len) {
     // sanity check
-    if(!ETH_Data_Received() || !ETH_isUp()) {
+    if(!ETH_Data_Received() || !linkUp) {
         return 0;
     }
 
@@ -288,7 +316,7 @@ unsigned int ETH_Receive_Frame(void *dst, unsigned int len) {
     // Note2: -4 to drop the CRC
     unsigned int frameSize = FRAME_RX_GET_SIZE(ptrFrameStatus) + 1 - 4;
     //
-    memcpy(dst, FRAME_GET_ADDR(LPC_EMAC->RxDescriptor, LPC_EMAC->RxConsumeIndex), MIN(len, frameSize));
+    frame_copy(dst, FRAME_GET_ADDR(LPC_EMAC->RxDescriptor, LPC_EMAC->RxConsumeIndex), MIN(len, frameSize));
     //
     update_consume_idx();
 
@@ -299,9 +327,9 @@ static void set_header(void *hdrPtr) {
     memcpy(hdrPtr, &mAddr, sizeof(eth_header));
 }
 
-unsigned int ETH_Send_Frame(void *src, unsigned int len) {
+RAMFUNC unsigned int ETH_Send_Frame(void *src, unsigned int len) {
     // sanity check
-    if(ETH_Data_Full() || !ETH_isUp()){
+    if(ETH_Data_Full() || !linkUp){
         return 0;
     }
 
@@ -312,7 +340,7 @@ unsigned int ETH_Send_Frame(void *src, unsigned int len) {
     // Set as last frame and generate interrupt
     ptrDescriptor->control |= 1 << 30 | 0x1 << 31;
 
-    memcpy((void *)ptrDescriptor->addr, src, len);
+    frame_copy((void *)ptrDescriptor->addr, src, len);
     //set_header((void *)ptrDescriptor->addr);
 
     update_produce_idx();
@@ -10,128 +10,480 @@
 #include "main.h"
 #include "flash_drv.h"
 #include "timer_drv.h"
+#include "crc.h"
+#include "prof.h"
+
+/// One EEPROM page held in RAM. Bytes never read nor written are not valid.
+typedef struct flash_cache_line_t {
+    unsigned int page;
+    unsigned int lastUse;                           //!< LRU stamp, bigger is more recent
+    unsigned char inUse;
+    unsigned char valid[FLASH_MAX_PAGE_SIZE / 8];   //!< One bit per byte holding EEPROM contents
+    unsigned char dirty[FLASH_MAX_PAGE_SIZE / 8];   //!< One bit per byte not yet written back
+    unsigned char data[FLASH_MAX_PAGE_SIZE];
+} flash_cache_line;
+
+static flash_cache_line cache[FLASH_CACHE_LINES];
+static unsigned int cacheClock;
+
+/// Range erase in progress
+typedef struct flash_erase_job_t {
+    unsigned int addr;
+    unsigned int end;
+    unsigned int flags;
+    unsigned char active;
+} flash_erase_job;
+
+static flash_erase_job eraseJob;
+static unsigned char writePending;      //!< The EEPROM may still be in its internal write cycle
+
+/// State of a read consumed byte by byte
+typedef struct flash_stream_t {
+    unsigned int addr;                  //!< Address of the next byte
+    unsigned int end;
+    const unsigned char *expected;      //!< Data to compare with
+    const uint32_t *pageCrc;            //!< Digests to compare with, one per page
+    uint32_t crc;
+    unsigned int mismatch;
+} flash_stream;
+
+const flash_device FLASH_24LC64  = { 8 * 1024UL,   64,  DEVICE_ADDR, 2, 0, 5 };
+const flash_device FLASH_24LC512 = { 64 * 1024UL,  128, DEVICE_ADDR, 2, 0, 5 };
+const flash_device FLASH_24CM02  = { 256 * 1024UL, 256, DEVICE_ADDR, 2, 2, 10 };
+
+static const flash_device *device = &FLASH_24LC64;
+static unsigned char selectedAddr;      //!< I2C address of the block being accessed
+
+static unsigned int blockdev_read(const block_device *dev, uint32_t addr, void *dst, uint32_t size);
+static unsigned int blockdev_prog(const block_device *dev, uint32_t addr, const void *src, uint32_t size);
+static unsigned int blockdev_erase(const block_device *dev, uint32_t addr, uint32_t size);
+static unsigned int blockdev_sync(const block_device *dev);
+
+static block_device blockDevice = {
+    0, 1, 1, 1, 0,
+    blockdev_read, blockdev_prog, blockdev_erase, blockdev_sync,
+    0
+};
+
+#define BIT_GET(map, idx)                           ((map)[(idx) >> 3] & (0x1 << ((idx) & 0x7)))
+#define BIT_SET(map, idx)                           ((map)[(idx) >> 3] |= (0x1 << ((idx) & 0x7)))
+#define BIT_CLR(map, idx)                           ((map)[(idx) >> 3] &= ~(0x1 << ((idx) & 0x7)))
+
+static unsigned int device_write_run(unsigned int dstAddr, const void *srcAddr, unsigned int size);
+static unsigned int device_read_page(void *dstAddr, void *srcAddr);
+static unsigned int device_wait_ready(void);
 
-// TODO: find another solution
-static char erase_buffer[FLASH_PAGE_SIZE];
-//
-static char read_buffer[FLASH_PAGE_SIZE];
-static unsigned char pageData[FLASH_PAGE_SIZE];
+void FLASH_Init(void) {
+    FLASH_InitDevice(&FLASH_24LC64);
+}
+
+unsigned int FLASH_InitDevice(const flash_device *dev) {
+    if(dev->pageSize == 0 || dev->pageSize > FLASH_MAX_PAGE_SIZE || (dev->pageSize & (dev->pageSize - 1)) ||
+       dev->addrBytes < 1 || dev->addrBytes > 2 || dev->size % dev->pageSize ||
+       dev->size > (1UL << (8 * dev->addrBytes + dev->blockBits))) {
+        return FLASH_OPER_FAIL;
+    }
+    device = dev;
+    blockDevice.size = dev->size;
+    blockDevice.blockSize = dev->pageSize;
 
+    I2C0_Init();
+    memset(cache, 0, sizeof(cache));
+    cacheClock = 0;
+    eraseJob.active = 0;
+    // A reset may have hit the EEPROM in the middle of a write cycle
+    writePending = 1;
 
-unsigned int FLASH_ErasePages(unsigned int startSector, unsigned int endSector) {
-    int retVal;
-    short addr = PAGE_TO_ADDR(startSector);
+    return FLASH_OPER_SUCCESS;
+}
+
+const flash_device *FLASH_GetDevice(void) {
+    return device;
+}
+
+const block_device *FLASH_GetBlockDevice(void) {
+    return &blockDevice;
+}
+
+static flash_cache_line *cache_lookup(unsigned int page) {
+    int i;
+    for(i = 0; i < FLASH_CACHE_LINES; i++) {
+        if(cache[i].inUse && cache[i].page == page) {
+            return &cache[i];
+        }
+    }
+    return 0;
+}
+
+static unsigned int range_is_valid(const flash_cache_line *line, unsigned int offset, unsigned int size) {
+    for(; size > 0; offset++, size--) {
+        if(!BIT_GET(line->valid, offset)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Writes the dirty bytes of a line back to the EEPROM. When every byte between the first
+ * and the last dirty one is known, they all go in a single transaction (one tWR); otherwise
+ * each contiguous dirty run is written on its own. Nothing is ever read back first.
+ */
+static unsigned int cache_write_back(flash_cache_line *line) {
+    unsigned int first = 0;
+    unsigned int last = device->pageSize;
+    unsigned int pageBaseAddr = PAGE_TO_ADDR(line->page);
+    unsigned int retVal;
+
+    while(first < device->pageSize && !BIT_GET(line->dirty, first)) first++;
+    if(first == device->pageSize) {
+        return FLASH_OPER_SUCCESS;
+    }
+    while(!BIT_GET(line->dirty, last - 1)) last--;
+
+    if(range_is_valid(line, first, last - first)) {
+        retVal = device_write_run(pageBaseAddr + first, line->data + first, last - first);
+        if(retVal != FLASH_OPER_SUCCESS) {
+            return retVal;
+        }
+    }
+    else {
+        unsigned int runStart;
+        while(first < last) {
+            runStart = first;
+            while(first < last && BIT_GET(line->dirty, first)) first++;
+
+            retVal = device_write_run(pageBaseAddr + runStart, line->data + runStart, first - runStart);
+            if(retVal != FLASH_OPER_SUCCESS) {
+                return retVal;
+            }
+            while(first < last && !BIT_GET(line->dirty, first)) first++;
+        }
+    }
 
-    while(startSector <= endSector) {
-        retVal = FLASH_WritePage((void *)addr, (void *)erase_buffer);
+    memset(line->dirty, 0, sizeof(line->dirty));
+    return FLASH_OPER_SUCCESS;
+}
+
+/**
+ * Makes every byte of a line valid: pending bytes are written back, then the whole page is
+ * read from the EEPROM.
+ */
+static unsigned int cache_fill(flash_cache_line *line) {
+    unsigned int retVal = cache_write_back(line);
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    retVal = device_read_page(line->data, (void *)PAGE_TO_ADDR(line->page));
+    if(retVal != FLASH_OPER_SUCCESS) {
+        line->inUse = 0;
+        return retVal;
+    }
+    memset(line->valid, 0xFF, sizeof(line->valid));
+
+    return FLASH_OPER_SUCCESS;
+}
+
+/**
+ * Returns the line holding 'page', allocating an empty one on a miss (the EEPROM is not read).
+ * The least recently used line is written back and reused when the cache is full.
+ */
+static flash_cache_line *cache_get(unsigned int page) {
+    flash_cache_line *line = cache_lookup(page);
+    if(line) {
+        line->lastUse = ++cacheClock;
+        return line;
+    }
+
+    // Pick a victim: a free line or the least recently used one
+    int i;
+    line = &cache[0];
+    for(i = 0; i < FLASH_CACHE_LINES; i++) {
+        if(!cache[i].inUse) {
+            line = &cache[i];
+            break;
+        }
+        if(cache[i].lastUse < line->lastUse) {
+            line = &cache[i];
+        }
+    }
+
+    if(line->inUse && cache_write_back(line) != FLASH_OPER_SUCCESS) {
+        return 0;
+    }
+
+    line->page = page;
+    line->inUse = 1;
+    memset(line->valid, 0, sizeof(line->valid));
+    memset(line->dirty, 0, sizeof(line->dirty));
+    line->lastUse = ++cacheClock;
+
+    return line;
+}
+
+unsigned int FLASH_Flush(void) {
+    int i;
+    for(i = 0; i < FLASH_CACHE_LINES; i++) {
+        if(!cache[i].inUse) {
+            continue;
+        }
+        unsigned int retVal = cache_write_back(&cache[i]);
         if(retVal != FLASH_OPER_SUCCESS) {
+            return retVal;
+        }
+    }
+
+    // Return once the data is actually committed
+    return device_wait_ready();
+}
+
+unsigned int FLASH_WritePage(void *dstAddr, void *srcAddr) {
+    unsigned int retVal = device_write_run((unsigned int)dstAddr, srcAddr, device->pageSize);
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    // Keep a cached copy coherent with what was just written
+    flash_cache_line *line = cache_lookup(ADDR_TO_PAGE((unsigned int)dstAddr));
+    if(line) {
+        memcpy(line->data, srcAddr, device->pageSize);
+        memset(line->valid, 0xFF, sizeof(line->valid));
+        memset(line->dirty, 0, sizeof(line->dirty));
+    }
+
+    return FLASH_OPER_SUCCESS;
+}
+
+unsigned int FLASH_ReadPage(void *dstAddr, void *srcAddr) {
+    flash_cache_line *line = cache_lookup(ADDR_TO_PAGE((unsigned int)srcAddr));
+    if(line) {
+        if(!range_is_valid(line, 0, device->pageSize) && cache_fill(line) != FLASH_OPER_SUCCESS) {
             return FLASH_OPER_FAIL;
         }
+        memcpy(dstAddr, line->data, device->pageSize);
+        return FLASH_OPER_SUCCESS;
+    }
+
+    return device_read_page(dstAddr, srcAddr);
+}
 
-        startSector++;
-        addr = PAGE_TO_ADDR(startSector);
-        Delay(5);
+/**
+ * ACK polling: the EEPROM does not acknowledge its address while a write cycle is running.
+ * \return 1 if the device is ready to accept a new command
+ */
+static unsigned int device_is_ready(void) {
+    if(!writePending) {
+        return 1;
     }
 
+    // On NACK the I2C driver already releases the bus
+    if(I2C0_Start_Comunication(0, device->devAddr, WRITE_OPERATION) != I2C_OPERATION_OK) {
+        return 0;
+    }
+    I2C0_Stop_Comunication();
+    writePending = 0;
 
-    // Stop
-    retVal = I2C0_Stop_Comunication();
-    if(retVal != I2C_OPERATION_OK) {
+    return 1;
+}
+
+static unsigned int device_wait_ready(void) {
+    unsigned int deadline = timer_deadline(MSToTicks(device->twrMs + FLASH_READY_MARGIN_MS));
+
+    do {
+        if(device_is_ready()) {
+            return FLASH_OPER_SUCCESS;
+        }
+    } while(!timer_expired(deadline));
+
+    return FLASH_OPER_FAIL;
+}
+
+/**
+ * Waits for the device and sends the start condition and the memory address.
+ * Address bits above the 'addrBytes' sent go in the block select bits of the device address.
+ */
+static unsigned int device_select(unsigned int addr) {
+    char memAddr[2];
+    unsigned int addrBits = 8 * device->addrBytes;
+
+    if(device_wait_ready() != FLASH_OPER_SUCCESS) {
+        return FLASH_OPER_FAIL;
+    }
+    selectedAddr = device->devAddr | ((addr >> addrBits) & ((0x1 << device->blockBits) - 1));
+    if(I2C0_Start_Comunication(0, selectedAddr, WRITE_OPERATION) != I2C_OPERATION_OK) {
+        return FLASH_OPER_FAIL;
+    }
+
+    // Big endian
+    memAddr[0] = (char)(addr >> 8);
+    memAddr[1] = (char)addr;
+    if(I2C0_Send_Data(&memAddr[2 - device->addrBytes], device->addrBytes) != I2C_OPERATION_OK) {
         return FLASH_OPER_FAIL;
     }
 
     return FLASH_OPER_SUCCESS;
 }
 
-void FLASH_Init(void) {
-    I2C0_Init();
-    memset(&erase_buffer, FLASH_DEFAULT_VALUE, FLASH_PAGE_SIZE);
+/**
+ * \return Bytes from 'addr' to the end of its block, a sequential read must not go past it
+ */
+static unsigned int block_remaining(unsigned int addr) {
+    unsigned int blockSize = 0x1UL << (8 * device->addrBytes);
+    return blockSize - (addr & (blockSize - 1));
 }
 
-unsigned int FLASH_WritePage(void *dstAddr, void *srcAddr) {
-    int retVal;
-    retVal = I2C0_Start_Comunication( 0, DEVICE_ADDR, WRITE_OPERATION);
-    if(retVal != I2C_OPERATION_OK) {
+/**
+ * Ends a write command. The EEPROM starts its internal write cycle (tWR) on the STOP;
+ * instead of a fixed delay the next command polls for its end.
+ */
+static unsigned int device_commit(void) {
+    if(I2C0_Stop_Comunication() != I2C_OPERATION_OK) {
         return FLASH_OPER_FAIL;
     }
+    writePending = 1;
 
-    // send write address
-    unsigned short bigendianAddr = TO_BIG_ENDIAN_SHORT(dstAddr);
-    retVal = I2C0_Send_Data((char*)&bigendianAddr, 2);
-    if(retVal != I2C_OPERATION_OK) {
+    return FLASH_OPER_SUCCESS;
+}
+
+/**
+ * Writes a contiguous run of bytes that must not cross a page boundary.
+ * 24xx parts latch only the bytes actually sent, so no read-modify-write is needed.
+ */
+static unsigned int device_write_run(unsigned int dstAddr, const void *srcAddr, unsigned int size) {
+    if(device_select(dstAddr) != FLASH_OPER_SUCCESS) {
         return FLASH_OPER_FAIL;
     }
     // send data
-    retVal = I2C0_Send_Data((char *)srcAddr, FLASH_PAGE_SIZE);
-    if(retVal != I2C_OPERATION_OK) {
+    if(I2C0_Send_Data((char *)srcAddr, size) != I2C_OPERATION_OK) {
         return FLASH_OPER_FAIL;
     }
-    
-    // Stop
-    retVal = I2C0_Stop_Comunication();
-    if(retVal != I2C_OPERATION_OK) {
+
+    return device_commit();
+}
+
+/**
+ * Writes 'size' FLASH_DEFAULT_VALUE bytes, within one page, straight from the I2C data register
+ */
+static unsigned int device_fill_run(unsigned int dstAddr, unsigned int size) {
+    if(device_select(dstAddr) != FLASH_OPER_SUCCESS) {
+        return FLASH_OPER_FAIL;
+    }
+    if(I2C0_Send_Fill((char)FLASH_DEFAULT_VALUE, size) != I2C_OPERATION_OK) {
         return FLASH_OPER_FAIL;
     }
 
-
-    // According to the datasheet writing to a page can take up to 5000ns
-    // Because it's easy for the caller to forget, do the delay here
-    Delay(5);
-    return FLASH_OPER_SUCCESS;
+    return device_commit();
 }
 
-unsigned int FLASH_ReadPage(void *dstAddr, void *srcAddr) {
+static unsigned int device_read_page(void *dstAddr, void *srcAddr) {
     int retVal;
 
-    retVal = I2C0_Start_Comunication(0, DEVICE_ADDR, WRITE_OPERATION);
-    if(retVal != I2C_OPERATION_OK) {
-        return FLASH_OPER_FAIL;
-    }
-    // Set read address
-    unsigned short bigendianAddr = TO_BIG_ENDIAN_SHORT(srcAddr);
-    retVal = I2C0_Send_Data((char*)&bigendianAddr, sizeof(short));
-    if(retVal != I2C_OPERATION_OK) {
+    retVal = device_select((unsigned int)srcAddr);
+    if(retVal != FLASH_OPER_SUCCESS) {
         return FLASH_OPER_FAIL;
     }
     // Begin read operation
-    retVal = I2C0_Start_Comunication( 1, DEVICE_ADDR, READ_OPERATION);
+    retVal = I2C0_Start_Comunication( 1, selectedAddr, READ_OPERATION);
     if(retVal != I2C_OPERATION_OK) {
         return FLASH_OPER_FAIL;
     }
     // Read
-    retVal = I2C0_Receive_Data(dstAddr, FLASH_PAGE_SIZE);
+    retVal = I2C0_Receive_Data(dstAddr, device->pageSize);
     if(retVal != I2C_OPERATION_OK) {
         return FLASH_OPER_FAIL;
     }
-    Delay(1);
     // Stop
     I2C0_Stop_Comunication();
 
     return FLASH_OPER_SUCCESS;
 }
 
+/**
+ * Reads 'size' bytes, handing each byte to 'handler' as it arrives. One transaction per
+ * device block; a handler returning non-zero must set 'mismatch'.
+ */
+static unsigned int device_stream(unsigned int addr, unsigned int size, i2c_rx_handler handler, flash_stream *stream) {
+    unsigned int chunk;
+
+    stream->addr = addr;
+    stream->end = addr + size;
+    stream->mismatch = 0;
+
+    while(size > 0 && !stream->mismatch) {
+        chunk = block_remaining(addr);
+        if(chunk > size) {
+            chunk = size;
+        }
+        if(device_select(addr) != FLASH_OPER_SUCCESS) {
+            return FLASH_OPER_FAIL;
+        }
+        if(I2C0_Start_Comunication(1, selectedAddr, READ_OPERATION) != I2C_OPERATION_OK) {
+            return FLASH_OPER_FAIL;
+        }
+        if(I2C0_Receive_Stream(chunk, handler, stream) != I2C_OPERATION_OK) {
+            return FLASH_OPER_FAIL;
+        }
+        I2C0_Stop_Comunication();
+
+        addr += chunk;
+        size -= chunk;
+    }
+
+    return FLASH_OPER_SUCCESS;
+}
+
+static int blank_check_handler(char data, void *ctx) {
+    flash_stream *stream = (flash_stream *)ctx;
+    if((unsigned char)data != FLASH_DEFAULT_VALUE) {
+        stream->mismatch = 1;
+        return 1;
+    }
+    return 0;
+}
 
-unsigned int FLASH_ReadData(void *dstAddr, void *srcAddr, unsigned int size) {
-    // TODO: This could be improved by write byte by byte instead of writing an entire page
-    // if size is less then half a FLASH_PAGE_SIZE. Otherwise write page
+static int compare_handler(char data, void *ctx) {
+    flash_stream *stream = (flash_stream *)ctx;
+    if((unsigned char)data != *stream->expected++) {
+        stream->mismatch = 1;
+        return 1;
+    }
+    return 0;
+}
 
-    unsigned int len;
-    do {
-        unsigned int retVal = FLASH_ReadPage(read_buffer, srcAddr);
-        if(retVal != FLASH_OPER_SUCCESS) {
-            return retVal;
+static int crc_handler(char data, void *ctx) {
+    flash_stream *stream = (flash_stream *)ctx;
+    stream->crc = CRC32_UpdateByte(stream->crc, data);
+    return 0;
+}
+
+static int page_crc_handler(char data, void *ctx) {
+    flash_stream *stream = (flash_stream *)ctx;
+    stream->crc = CRC32_UpdateByte(stream->crc, data);
+    stream->addr++;
+
+    // End of a page or of the range: check the page digest
+    if(ADDR_TO_PAGE_OFFSET(stream->addr) == 0 || stream->addr == stream->end) {
+        if(CRC32_FINAL(stream->crc) != *stream->pageCrc++) {
+            stream->addr--;
+            stream->mismatch = 1;
+            return 1;
         }
+        stream->crc = CRC32_INIT;
+    }
+    return 0;
+}
 
-        // update size and len
-        len = (size > FLASH_PAGE_SIZE)? FLASH_PAGE_SIZE : size;
-        size -= len;
-        // copy
-        memcpy(dstAddr, read_buffer, len);
+/**
+ * Checks if 'size' bytes are erased, stopping at the first one that is not
+ */
+static unsigned int device_is_blank(unsigned int addr, unsigned int size, unsigned int *blank) {
+    flash_stream stream;
 
-        // update pointers
-        dstAddr = ((char *)dstAddr) + len;
-        srcAddr = ((char *)srcAddr) + len;
-    } while(size > 0);
+    if(device_stream(addr, size, blank_check_handler, &stream) != FLASH_OPER_SUCCESS) {
+        return FLASH_OPER_FAIL;
+    }
+    *blank = !stream.mismatch;
 
     return FLASH_OPER_SUCCESS;
 }
@@ -139,76 +491,243 @@ unsigned int FLASH_ReadData(void *dstAddr, void *srcAddr, unsigned int size) {
 
 static unsigned int calcCopySize(const unsigned int startAddr, const unsigned int size) {
     unsigned int sector = ADDR_TO_PAGE((unsigned int)startAddr);
-    unsigned int sectorStartAddr = sector * FLASH_PAGE_SIZE;
-    unsigned int sectorEndAddr = sectorStartAddr + FLASH_PAGE_SIZE - 1;
+    unsigned int sectorStartAddr = sector * device->pageSize;
+    unsigned int sectorEndAddr = sectorStartAddr + device->pageSize - 1;
     unsigned int offsetSize = (sectorEndAddr - startAddr + 1);
 
     return (offsetSize >= size)? size : offsetSize;
 }
 
-static unsigned int mapFlashAddrToStackAddr(unsigned int flashAddr, unsigned int stackAddr, unsigned int sector) {
-    unsigned int sectorStartAddr = sector * FLASH_PAGE_SIZE;
-    unsigned int flashOffset = flashAddr - sectorStartAddr;
+unsigned int FLASH_ReadData(void *dstAddr, void *srcAddr, unsigned int size) {
+    if( ((unsigned int) srcAddr) + size > FLASH_BASE_ADDR + device->size ) return FLASH_OPER_FAIL;
+
+    unsigned int sector;
+    unsigned int sizeToCopy;
+    unsigned int offset;
+    flash_cache_line *line;
+    while(size > 0) {
+        sector = ADDR_TO_PAGE((unsigned int)srcAddr);
+        line = cache_get(sector);
+        if(!line) {
+            return FLASH_OPER_FAIL;
+        }
+
+        sizeToCopy = calcCopySize((unsigned int)srcAddr, size);
+        offset = ADDR_TO_PAGE_OFFSET((unsigned int)srcAddr);
+        if(!range_is_valid(line, offset, sizeToCopy) && cache_fill(line) != FLASH_OPER_SUCCESS) {
+            return FLASH_OPER_FAIL;
+        }
+        memcpy(dstAddr, line->data + offset, sizeToCopy);
+
+        dstAddr = ((char *)dstAddr) + sizeToCopy;
+        srcAddr = ((char *)srcAddr) + sizeToCopy;
+        size -= sizeToCopy;
+    }
 
-    return stackAddr + flashOffset;
+    return FLASH_OPER_SUCCESS;
 }
 
-unsigned int FLASH_WriteData(void *dstAddr, void *srcAddr, unsigned int size) {
-    if( ((unsigned int) dstAddr) + size > FLASH_BASE_ADDR + FLASH_SIZE - 1 ) return FLASH_OPER_FAIL;
-    if(size > FLASH_SIZE) return FLASH_OPER_FAIL;
 
-    int retVal;
+unsigned int FLASH_WriteData(void *dstAddr, void *srcAddr, unsigned int size) {
+    if( ((unsigned int) dstAddr) + size > FLASH_BASE_ADDR + device->size ) return FLASH_OPER_FAIL;
+    if(size > device->size) return FLASH_OPER_FAIL;
 
     unsigned int sector;
-    unsigned int pageBaseAddr;
     unsigned int sizeToCopy;
-    unsigned int stackDstAddr;
-    do {
+    unsigned int offset;
+    unsigned int i;
+    unsigned char *src;
+    flash_cache_line *line;
+    PROF_BEGIN(flashWriteData);             // Successful calls only
+    while(size > 0) {
         sector = ADDR_TO_PAGE((unsigned int)dstAddr);
-        pageBaseAddr = PAGE_TO_ADDR(sector);
-
-        FLASH_ReadPage(pageData, (void *)pageBaseAddr);
+        line = cache_get(sector);
+        if(!line) {
+            return FLASH_OPER_FAIL;
+        }
 
         sizeToCopy = calcCopySize((unsigned int)dstAddr, size);
-        stackDstAddr = mapFlashAddrToStackAddr((unsigned int)dstAddr, (unsigned int)pageData, sector);
-        memcpy((void *)stackDstAddr, srcAddr, sizeToCopy);
-
-        retVal = FLASH_WritePage((void *)pageBaseAddr, pageData);
-        if(retVal != FLASH_OPER_SUCCESS) {
-            return retVal;
+        offset = ADDR_TO_PAGE_OFFSET((unsigned int)dstAddr);
+        src = (unsigned char *)srcAddr;
+        // Only dirty the bytes that actually change
+        for(i = 0; i < sizeToCopy; i++, offset++) {
+            if(BIT_GET(line->valid, offset) && line->data[offset] == src[i]) {
+                continue;
+            }
+            line->data[offset] = src[i];
+            BIT_SET(line->valid, offset);
+            BIT_SET(line->dirty, offset);
         }
 
         dstAddr = ((char *)dstAddr) + sizeToCopy; // Bytes
         srcAddr = ((char *)srcAddr) + sizeToCopy; // Bytes
         size -= sizeToCopy;
+    }
+    PROF_END(flashWriteData);
 
-    } while(size > 0);
-    
     return FLASH_OPER_SUCCESS;
 }
 
 
 unsigned int FLASH_VerifyData(void *dstAddr, void *srcAddr, unsigned int size) {
+    flash_stream stream;
     int retVal;
 
-    unsigned int sizeToCopy;
-    do {
-        sizeToCopy = calcCopySize((unsigned int)dstAddr, size);
+    retVal = FLASH_Flush();
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
 
-        retVal = FLASH_ReadPage(read_buffer, dstAddr);
-        if(retVal != FLASH_OPER_SUCCESS) {
-            return retVal;
-        }
+    // Compare on the fly: no page buffer, single read transaction
+    stream.expected = (const unsigned char *)srcAddr;
+    retVal = device_stream((unsigned int)dstAddr, size, compare_handler, &stream);
+    if(retVal != FLASH_OPER_SUCCESS || stream.mismatch) {
+        return FLASH_OPER_FAIL;
+    }
 
-        if(memcmp(srcAddr, read_buffer, sizeToCopy) != 0) {
-            return FLASH_OPER_FAIL;
-        }
+    return FLASH_OPER_SUCCESS;
+}
 
-        dstAddr = ((char *)dstAddr) + sizeToCopy;
-        srcAddr = ((char *)srcAddr) + sizeToCopy;
-        size -= sizeToCopy;
+unsigned int FLASH_ComputeCrc32(unsigned int addr, unsigned int size, uint32_t *crc) {
+    flash_stream stream;
+    if(size > device->size || addr + size > FLASH_BASE_ADDR + device->size) return FLASH_OPER_FAIL;
+
+    unsigned int retVal = FLASH_Flush();
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
 
-    } while(size > 0);
+    stream.crc = CRC32_INIT;
+    retVal = device_stream(addr, size, crc_handler, &stream);
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+    *crc = CRC32_FINAL(stream.crc);
 
     return FLASH_OPER_SUCCESS;
 }
+
+unsigned int FLASH_VerifyCrc32(unsigned int addr, unsigned int size, const uint32_t *pageCrc, unsigned int *badPage) {
+    flash_stream stream;
+    if(size == 0 || size > device->size || addr + size > FLASH_BASE_ADDR + device->size) return FLASH_OPER_FAIL;
+
+    unsigned int retVal = FLASH_Flush();
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    stream.crc = CRC32_INIT;
+    stream.pageCrc = pageCrc;
+    retVal = device_stream(addr, size, page_crc_handler, &stream);
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+    if(stream.mismatch) {
+        *badPage = ADDR_TO_PAGE(stream.addr);
+        return FLASH_OPER_MISMATCH;
+    }
+
+    return FLASH_OPER_SUCCESS;
+}
+
+
+/**
+ * Marks an erased range as erased in the cache, dropping any pending write to it
+ */
+static void cache_erase(unsigned int addr, unsigned int size) {
+    flash_cache_line *line = cache_lookup(ADDR_TO_PAGE(addr));
+    if(!line) {
+        return;
+    }
+
+    unsigned int offset = ADDR_TO_PAGE_OFFSET(addr);
+    memset(line->data + offset, FLASH_DEFAULT_VALUE, size);
+    for(; size > 0; offset++, size--) {
+        BIT_SET(line->valid, offset);
+        BIT_CLR(line->dirty, offset);
+    }
+}
+
+unsigned int FLASH_EraseStart(unsigned int addr, unsigned int size, unsigned int flags) {
+    if(eraseJob.active) return FLASH_OPER_FAIL;
+    if(size > device->size || addr + size > FLASH_BASE_ADDR + device->size) return FLASH_OPER_FAIL;
+
+    eraseJob.addr = addr;
+    eraseJob.end = addr + size;
+    eraseJob.flags = flags;
+    eraseJob.active = (size > 0);
+
+    return FLASH_OPER_SUCCESS;
+}
+
+unsigned int FLASH_EraseProcess(void) {
+    unsigned int chunk;
+    unsigned int blank;
+
+    if(!eraseJob.active) {
+        return FLASH_OPER_SUCCESS;
+    }
+    // Never block on tWR: come back later
+    if(!device_is_ready()) {
+        return FLASH_OPER_BUSY;
+    }
+
+    // One page per call, written or found blank: a blank check reads it over the bus too
+    chunk = calcCopySize(eraseJob.addr, eraseJob.end - eraseJob.addr);
+    blank = 0;
+    if((eraseJob.flags & FLASH_ERASE_SKIP_BLANK) &&
+       device_is_blank(eraseJob.addr, chunk, &blank) != FLASH_OPER_SUCCESS) {
+        eraseJob.active = 0;
+        return FLASH_OPER_FAIL;
+    }
+    if(!blank && device_fill_run(eraseJob.addr, chunk) != FLASH_OPER_SUCCESS) {
+        eraseJob.active = 0;
+        return FLASH_OPER_FAIL;
+    }
+    cache_erase(eraseJob.addr, chunk);
+
+    eraseJob.addr += chunk;
+    eraseJob.active = (eraseJob.addr < eraseJob.end);
+
+    return eraseJob.active? FLASH_OPER_BUSY : FLASH_OPER_SUCCESS;
+}
+
+unsigned int FLASH_EraseRange(unsigned int addr, unsigned int size, unsigned int flags) {
+    unsigned int retVal = FLASH_EraseStart(addr, size, flags);
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    do {
+        retVal = FLASH_EraseProcess();
+    } while(retVal == FLASH_OPER_BUSY);
+    if(retVal != FLASH_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    return device_wait_ready();
+}
+
+unsigned int FLASH_ErasePages(unsigned int startPage, unsigned int endPage) {
+    if(endPage < startPage) return FLASH_OPER_FAIL;
+
+    return FLASH_EraseRange(PAGE_TO_ADDR(startPage), PAGE_TO_ADDR(endPage - startPage + 1), 0);
+}
+
+
+static unsigned int blockdev_read(const block_device *dev, uint32_t addr, void *dst, uint32_t size) {
+    return (FLASH_ReadData(dst, (void *)addr, size) == FLASH_OPER_SUCCESS)? BLOCKDEV_OPER_SUCCESS : BLOCKDEV_OPER_FAIL;
+}
+
+static unsigned int blockdev_prog(const block_device *dev, uint32_t addr, const void *src, uint32_t size) {
+    return (FLASH_WriteData((void *)addr, (void *)src, size) == FLASH_OPER_SUCCESS)? BLOCKDEV_OPER_SUCCESS : BLOCKDEV_OPER_FAIL;
+}
+
+static unsigned int blockdev_erase(const block_device *dev, uint32_t addr, uint32_t size) {
+    // Erasing through the cache keeps pending writes to the range from resurrecting it
+    return (FLASH_EraseRange(addr, size, FLASH_ERASE_SKIP_BLANK) == FLASH_OPER_SUCCESS)? BLOCKDEV_OPER_SUCCESS : BLOCKDEV_OPER_FAIL;
+}
+
+static unsigned int blockdev_sync(const block_device *dev) {
+    return (FLASH_Flush() == FLASH_OPER_SUCCESS)? BLOCKDEV_OPER_SUCCESS : BLOCKDEV_OPER_FAIL;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file     gpdma_drv.c
+ * @brief    General purpose DMA driver
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "gpdma_drv.h"
+#include "irqtrace.h"
+
+#define GPDMA_CHANNEL(ch)                   ((LPC_GPDMACH_TypeDef *)(LPC_GPDMACH0_BASE + 0x20 * (ch)))
+
+/// Completion callback of each channel
+typedef struct gpdma_channel_t {
+    gpdma_callback callback;
+    void *ctx;
+} gpdma_channel;
+
+static gpdma_channel channels[GPDMA_CHANNELS];
+
+void GPDMA_Init(void) {
+    unsigned int ch;
+
+    SET_GPDMA_POWER_ON;
+    for(ch = 0; ch < GPDMA_CHANNELS; ch++) {
+        GPDMA_CHANNEL(ch)->DMACCConfig = 0;
+        channels[ch].callback = 0;
+    }
+    LPC_GPDMA->DMACIntTCClear = 0xFF;
+    LPC_GPDMA->DMACIntErrClr = 0xFF;
+    // Little endian masters
+    LPC_GPDMA->DMACConfig = GPDMA_CONFIG_ENABLE;
+    while(!(LPC_GPDMA->DMACConfig & GPDMA_CONFIG_ENABLE));
+
+    NVIC_EnableIRQ(DMA_IRQn);
+}
+
+unsigned int GPDMA_BuildChain(gpdma_lli *lli, unsigned int maxItems, uint32_t srcAddr, uint32_t dstAddr,
+                              unsigned int count, uint32_t control) {
+    unsigned int srcStep = (control & GPDMA_CTRL_SI)? (0x1 << ((control >> 18) & 0x7)) : 0;
+    unsigned int dstStep = (control & GPDMA_CTRL_DI)? (0x1 << ((control >> 21) & 0x7)) : 0;
+    unsigned int items = 0;
+    unsigned int chunk;
+
+    do {
+        if(items == maxItems) {
+            return 0;
+        }
+        chunk = (count > GPDMA_MAX_TRANSFER)? GPDMA_MAX_TRANSFER : count;
+
+        lli[items].srcAddr = srcAddr;
+        lli[items].dstAddr = dstAddr;
+        lli[items].control = control | chunk;
+        lli[items].nextLLI = 0;
+        if(items > 0) {
+            lli[items - 1].nextLLI = (uint32_t)&lli[items];
+        }
+
+        srcAddr += chunk * srcStep;
+        dstAddr += chunk * dstStep;
+        count -= chunk;
+        items++;
+    } while(count > 0);
+
+    lli[items - 1].control |= GPDMA_CTRL_I;
+
+    return items;
+}
+
+unsigned int GPDMA_Start(unsigned int channel, const gpdma_lli *lli, uint32_t config, gpdma_callback callback, void *ctx) {
+    LPC_GPDMACH_TypeDef *ch;
+
+    if(channel >= GPDMA_CHANNELS || GPDMA_IsBusy(channel)) {
+        return GPDMA_OPER_FAIL;
+    }
+    ch = GPDMA_CHANNEL(channel);
+
+    channels[channel].callback = callback;
+    channels[channel].ctx = ctx;
+    LPC_GPDMA->DMACIntTCClear = 0x1 << channel;
+    LPC_GPDMA->DMACIntErrClr = 0x1 << channel;
+
+    ch->DMACCSrcAddr = lli->srcAddr;
+    ch->DMACCDestAddr = lli->dstAddr;
+    ch->DMACCLLI = lli->nextLLI;
+    ch->DMACCControl = lli->control;
+    ch->DMACCConfig = config | GPDMA_CH_IE | GPDMA_CH_ITC | GPDMA_CH_ENABLE;
+
+    return GPDMA_OPER_SUCCESS;
+}
+
+void GPDMA_Stop(unsigned int channel) {
+    if(channel >= GPDMA_CHANNELS) {
+        return;
+    }
+    GPDMA_CHANNEL(channel)->DMACCConfig &= ~GPDMA_CH_ENABLE;
+    LPC_GPDMA->DMACIntTCClear = 0x1 << channel;
+    LPC_GPDMA->DMACIntErrClr = 0x1 << channel;
+}
+
+unsigned int GPDMA_IsBusy(unsigned int channel) {
+    return (LPC_GPDMA->DMACEnbldChns >> channel) & 0x1;
+}
+
+void GPDMA_IRQHandler(void) {
+    uint32_t tc;
+    uint32_t err;
+    unsigned int ch;
+
+    IRQTRACE_ENTER(IRQTRACE_NO_LATENCY);
+    for(ch = 0; ch < GPDMA_CHANNELS; ch++) {
+        // Read per channel: a callback may stop or restart other channels, clearing what they had
+        // pending, and a stale status would then end their new transfer
+        tc = LPC_GPDMA->DMACIntTCStat & (0x1 << ch);
+        err = LPC_GPDMA->DMACIntErrStat & (0x1 << ch);
+        if(!(tc | err)) {
+            continue;
+        }
+        LPC_GPDMA->DMACIntTCClear = tc;
+        LPC_GPDMA->DMACIntErrClr = err;
+        if(err) {
+            // The controller disables a channel on error
+            GPDMA_CHANNEL(ch)->DMACCConfig &= ~GPDMA_CH_ENABLE;
+        }
+        if(channels[ch].callback) {
+            channels[ch].callback(ch, err? GPDMA_STATUS_ERROR : GPDMA_STATUS_DONE, channels[ch].ctx);
+        }
+    }
+    IRQTRACE_EXIT();
+}
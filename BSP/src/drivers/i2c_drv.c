@@ -43,10 +43,30 @@ static int check_status(void) {
 	}
 }
 
+/**
+ * Waits for the end of the current bus operation (SI set)
+ */
+static int wait_bus_ready(void) {
+	unsigned int deadline = timer_deadline(USToTicks(I2C0_TIMEOUT_US));
+
+	while(!I2C0_IS_BUS_READY) {
+		if(timer_expired(deadline)) {
+			// Stuck: let go of the bus
+			I2C0_SET_CONF(I2C0_BIT_STO | I2C0_BIT_AA);
+			I2C0_CLR_SI;
+			return I2C_OPERATION_NOK;
+		}
+	}
+
+	return I2C_OPERATION_OK;
+}
+
 static int I2C0_Send_Raw_Byte(char *data) {
 	I2C0_SET_DATA(data);
 	I2C0_SEND;
-	while(!I2C0_IS_BUS_READY);
+	if(wait_bus_ready() != I2C_OPERATION_OK) {
+		return I2C_OPERATION_NOK;
+	}
 
 	return check_status();
 }
@@ -90,7 +110,9 @@ int I2C0_Start_Comunication(int isRestart, char address, int operation) {
 	if(isRestart) {
 		I2C0_SEND;
 	}
-	while(!I2C0_IS_BUS_READY);
+	if(wait_bus_ready() != I2C_OPERATION_OK) {
+		return I2C_OPERATION_NOK;
+	}
 	//
 	I2C0_CLR_START_CONDITION;
 
@@ -127,13 +149,29 @@ int I2C0_Send_Data(char *data, int len) {
 	return retVal;
 }
 
+int I2C0_Send_Fill(char value, int len) {
+	int retVal = I2C_OPERATION_OK;
+
+	int i;
+	for(i = 0; i < len; i++) {
+		retVal = I2C0_Send_Raw_Byte(&value);
+		if(retVal == I2C_OPERATION_NOK) {
+			return retVal;
+		}
+	}
+
+	return retVal;
+}
+
 int I2C0_Receive_Byte(char *buff) {
 	int retVal;
 
 	// Send ACK
 	I2C0_SET_ACK;
 	I2C0_CLR_SI;
-	while(!I2C0_IS_BUS_READY);
+	if(wait_bus_ready() != I2C_OPERATION_OK) {
+		return I2C_OPERATION_NOK;
+	}
 	retVal = check_status();
 	if(retVal != I2C_OPERATION_OK) {
 		return retVal;
@@ -160,7 +198,9 @@ int I2C0_Receive_Data(char *buff, int len) {
 		// ACK
 		I2C0_SET_ACK;
 		I2C0_CLR_SI;
-		while(!I2C0_IS_BUS_READY);
+		if(wait_bus_ready() != I2C_OPERATION_OK) {
+			return I2C_OPERATION_NOK;
+		}
 		retVal = check_status();
 		if(retVal != I2C_OPERATION_OK) {
 			return retVal;
@@ -172,7 +212,44 @@ int I2C0_Receive_Data(char *buff, int len) {
 
 	// Send a NACK
 	I2C0_CLR_CONF(I2C0_BIT_AA | I2C0_BIT_SI);
-	while(!I2C0_IS_BUS_READY);
+	if(wait_bus_ready() != I2C_OPERATION_OK) {
+		return I2C_OPERATION_NOK;
+	}
+	if(I2C0_GET_STATUS != RECEIVE_ACK_NOK) {
+		return I2C_OPERATION_NOK;
+	}
+
+	return I2C_OPERATION_OK;
+}
+
+
+int I2C0_Receive_Stream(int len, i2c_rx_handler handler, void *ctx) {
+	int retVal;
+
+	int i;
+	for(i = 0; i < len; i++) {
+		// ACK
+		I2C0_SET_ACK;
+		I2C0_CLR_SI;
+		if(wait_bus_ready() != I2C_OPERATION_OK) {
+			return I2C_OPERATION_NOK;
+		}
+		retVal = check_status();
+		if(retVal != I2C_OPERATION_OK) {
+			return retVal;
+		}
+
+		if(handler(I2C0_GET_DATA, ctx)) {
+			break;
+		}
+	}
+
+
+	// Send a NACK
+	I2C0_CLR_CONF(I2C0_BIT_AA | I2C0_BIT_SI);
+	if(wait_bus_ready() != I2C_OPERATION_OK) {
+		return I2C_OPERATION_NOK;
+	}
 	if(I2C0_GET_STATUS != RECEIVE_ACK_NOK) {
 		return I2C_OPERATION_NOK;
 	}
@@ -0,0 +1,112 @@
+/**
+ * @file     irq_drv.c
+ * @brief    Interrupt configuration, applied from IRQ_TABLE
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "irq_drv.h"
+#include "common.h"
+
+/* Compile time checks: one enumerator per entry, so an interrupt listed twice is a redeclaration,
+   sized by a char array whose size is negative when the entry is invalid */
+#define IRQ_VALID(irq, preempt, sub, enabled) \
+    ((irq) >= MemoryManagement_IRQn && (irq) <= CANActivity_IRQn && \
+     (preempt) <= IRQ_LOWEST_PREEMPT && (sub) <= IRQ_LOWEST_SUB && (!(enabled) || (irq) >= 0))
+#define IRQ_CHECK(irq, preempt, sub, enabled) \
+    irq_table_has_##irq = sizeof(char[IRQ_VALID(irq, preempt, sub, enabled)? 1 : -1]),
+
+enum {
+    IRQ_TABLE(IRQ_CHECK)
+    irq_table_checked
+};
+
+/* Startup enables, one mask per NVIC->ISER register */
+#define IRQ_ENABLE_BIT(irq, preempt, sub, enabled, word) \
+    | (((enabled) && (irq) >= 32 * (word) && (irq) < 32 * ((word) + 1))? 0x1UL << ((irq) % 32) : 0)
+#define IRQ_ENABLE_WORD0(irq, preempt, sub, enabled)    IRQ_ENABLE_BIT(irq, preempt, sub, enabled, 0)
+#define IRQ_ENABLE_WORD1(irq, preempt, sub, enabled)    IRQ_ENABLE_BIT(irq, preempt, sub, enabled, 1)
+
+#define IRQ_ENABLE_MASK0                    (0 IRQ_TABLE(IRQ_ENABLE_WORD0))
+#define IRQ_ENABLE_MASK1                    (0 IRQ_TABLE(IRQ_ENABLE_WORD1))
+
+/// An entry of IRQ_TABLE
+typedef struct irq_config_t {
+    int8_t irq;
+    uint8_t priority;                       //!< IRQ_PRIORITY()
+} irq_config;
+
+#define IRQ_ENTRY(irq, preempt, sub, enabled) { (irq), IRQ_PRIORITY(preempt, sub) },
+
+static const irq_config irqTable[] = {
+    IRQ_TABLE(IRQ_ENTRY)
+};
+
+#if IRQ_RAM_VECTORS
+// VTOR needs the table aligned on its size rounded up to a power of two: 64 words
+#pragma data_alignment=256
+static irq_handler ramVectors[IRQ_VECTORS];
+
+/**
+ * Copies the vectors in use, from flash or from where the debugger put them, and switches to
+ * the copy
+ */
+static void vectors_to_ram(void) {
+    const irq_handler *current = (const irq_handler *)SCB->VTOR;
+    unsigned int index;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    for(index = 0; index < IRQ_VECTORS; index++) {
+        ramVectors[index] = current[index];
+    }
+    __DSB();
+    SCB->VTOR = (uint32_t)ramVectors & SCB_VTOR_TBLOFF_Msk;
+    __DSB();
+    __ISB();
+    CRITICAL_EXIT(state);
+}
+#endif
+
+void IRQ_Init(void) {
+    unsigned int index;
+    int irq;
+
+#if IRQ_RAM_VECTORS
+    vectors_to_ram();
+#endif
+    NVIC_SetPriorityGrouping(IRQ_PRIORITY_GROUP);
+    // Out of reset every interrupt is at 0, level with the memory management fault
+    for(irq = 0; irq < IRQ_VECTORS - 16; irq++) {
+        NVIC_SetPriority((IRQn_Type)irq, IRQ_PRIORITY(IRQ_DEFAULT_PREEMPT, 0));
+    }
+    for(index = 0; index < sizeof(irqTable) / sizeof(irqTable[0]); index++) {
+        NVIC_SetPriority((IRQn_Type)irqTable[index].irq, irqTable[index].priority);
+    }
+    NVIC->ISER[0] = IRQ_ENABLE_MASK0;
+    NVIC->ISER[1] = IRQ_ENABLE_MASK1;
+}
+
+void IRQ_SetPriority(IRQn_Type irq, unsigned int preempt, unsigned int sub) {
+    if(preempt > IRQ_LOWEST_PREEMPT || sub > IRQ_LOWEST_SUB) {
+        return;
+    }
+    NVIC_SetPriority(irq, IRQ_PRIORITY(preempt, sub));
+}
+
+unsigned int irq_register(IRQn_Type irq, irq_handler handler) {
+#if IRQ_RAM_VECTORS
+    if(irq < MemoryManagement_IRQn || irq > CANActivity_IRQn || !handler
+       || SCB->VTOR != ((uint32_t)ramVectors & SCB_VTOR_TBLOFF_Msk)) {
+        return IRQ_OPER_FAIL;
+    }
+    // A single word: the core sees either handler
+    ramVectors[16 + irq] = handler;
+    __DSB();
+
+    return IRQ_OPER_SUCCESS;
+#else
+    return IRQ_OPER_FAIL;
+#endif
+}
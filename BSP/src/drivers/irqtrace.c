@@ -0,0 +1,173 @@
+/**
+ * @file     irqtrace.c
+ * @brief    Interrupt tracer: lock-free event ring and per exception statistics
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <string.h>
+
+#include "irqtrace.h"
+#include "common.h"
+
+#define IRQTRACE_HEADER_SIZE                20
+
+static irqtrace_event ring[IRQTRACE_EVENTS];
+static volatile uint32_t ringHead;          //!< Events ever recorded, ring[ringHead % IRQTRACE_EVENTS] is next
+static volatile uint32_t recording;
+
+// Only ever written by the handler of their exception, which cannot preempt itself
+static irqtrace_stats stats[IRQTRACE_EXCEPTIONS];
+static uint32_t entryCycles[IRQTRACE_EXCEPTIONS];
+
+static void stats_clear(void) {
+    unsigned int exception;
+
+    memset(stats, 0, sizeof(stats));
+    for(exception = 0; exception < IRQTRACE_EXCEPTIONS; exception++) {
+        stats[exception].latencyMin = 0xFFFFFFFF;
+        stats[exception].durationMin = 0xFFFFFFFF;
+    }
+}
+
+void IRQTRACE_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    IRQTRACE_Reset();
+    recording = 1;
+}
+
+/**
+ * Takes a slot and fills it. Handlers preempting each other get distinct slots: the
+ * exclusive monitor is cleared on every exception entry and return.
+ */
+static void record(uint32_t cycles, unsigned int exception, unsigned int kind, uint32_t latency) {
+    irqtrace_event *event;
+    uint32_t index;
+
+    if(!recording) {
+        return;
+    }
+    do {
+        index = __LDREXW(&ringHead);
+    } while(__STREXW(index + 1, &ringHead));
+
+    event = &ring[index & (IRQTRACE_EVENTS - 1)];
+    event->cycles = cycles;
+    event->exception = exception;
+    event->kind = kind;
+    if(latency == IRQTRACE_NO_LATENCY) {
+        event->latency = IRQTRACE_NO_LATENCY;
+    }
+    else {
+        // A long latency must not read as an unknown one
+        event->latency = (latency > IRQTRACE_MAX_LATENCY)? IRQTRACE_MAX_LATENCY : latency;
+    }
+}
+
+void IRQTRACE_Enter(uint32_t latency) {
+    uint32_t cycles = DWT->CYCCNT;
+    unsigned int exception = __get_IPSR() & 0xFF;
+    irqtrace_stats *entry;
+
+    if(exception >= IRQTRACE_EXCEPTIONS) {
+        return;
+    }
+    entryCycles[exception] = cycles;
+    record(cycles, exception, IRQTRACE_EVENT_ENTER, latency);
+
+    entry = &stats[exception];
+    entry->count++;
+    if(latency != IRQTRACE_NO_LATENCY) {
+        entry->latencyCount++;
+        entry->latencyTotal += latency;
+        if(latency < entry->latencyMin) {
+            entry->latencyMin = latency;
+        }
+        if(latency > entry->latencyMax) {
+            entry->latencyMax = latency;
+        }
+    }
+}
+
+void IRQTRACE_Exit(void) {
+    uint32_t cycles = DWT->CYCCNT;
+    unsigned int exception = __get_IPSR() & 0xFF;
+    irqtrace_stats *entry;
+    uint32_t duration;
+
+    if(exception >= IRQTRACE_EXCEPTIONS) {
+        return;
+    }
+    record(cycles, exception, IRQTRACE_EVENT_EXIT, 0);
+
+    entry = &stats[exception];
+    duration = cycles - entryCycles[exception];
+    entry->durationTotal += duration;
+    if(duration < entry->durationMin) {
+        entry->durationMin = duration;
+    }
+    if(duration > entry->durationMax) {
+        entry->durationMax = duration;
+    }
+}
+
+const irqtrace_stats *IRQTRACE_GetStats(unsigned int exception) {
+    if(exception >= IRQTRACE_EXCEPTIONS) {
+        return 0;
+    }
+    return &stats[exception];
+}
+
+void IRQTRACE_Reset(void) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    stats_clear();
+    ringHead = 0;
+    CRITICAL_EXIT(state);
+}
+
+static void put32(uint8_t *dst, uint32_t value) {
+    dst[0] = value;
+    dst[1] = value >> 8;
+    dst[2] = value >> 16;
+    dst[3] = value >> 24;
+}
+
+void IRQTRACE_Export(irqtrace_output output, void *ctx) {
+    uint8_t header[IRQTRACE_HEADER_SIZE];
+    uint32_t head, count, first, start, span;
+
+    // Paused from thread mode: once here, no handler is halfway through a record
+    recording = 0;
+    head = ringHead;
+    count = (head < IRQTRACE_EVENTS)? head : IRQTRACE_EVENTS;
+    first = head - count;
+
+    memcpy(header, "IRQT", 4);
+    header[4] = IRQTRACE_FORMAT_VERSION;
+    header[5] = sizeof(irqtrace_event);
+    header[6] = 0;
+    header[7] = 0;
+    put32(header + 8, SystemCoreClock);
+    put32(header + 12, count);
+    put32(header + 16, first);
+    output(header, sizeof(header), ctx);
+
+    // The core is little endian: events go out as they are, in two spans if the ring wrapped
+    start = first & (IRQTRACE_EVENTS - 1);
+    span = IRQTRACE_EVENTS - start;
+    if(span > count) {
+        span = count;
+    }
+    if(span) {
+        output(&ring[start], span * sizeof(irqtrace_event), ctx);
+    }
+    if(count > span) {
+        output(ring, (count - span) * sizeof(irqtrace_event), ctx);
+    }
+    recording = 1;
+}
@@ -0,0 +1,593 @@
+/**
+ * @file     kernel.c
+ * @brief    Preemptive kernel: ready lists, mutexes with priority inheritance and queues.
+ *           The processor side is in the port, see kernel_port.h.
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <string.h>
+
+#include "kernel.h"
+#include "kernel_port.h"
+#include "sched.h"
+#include "common.h"
+
+#define STATE_READY                         0           // Running, or in its ready list
+#define STATE_SLEEPING                      1
+#define STATE_MUTEX                         2           // waitingOn: the kernel_mutex
+#define STATE_SENDING                       3           // waitingOn: the kernel_queue
+#define STATE_RECEIVING                     4           // waitingOn: the kernel_queue
+#define STATE_ENDED                         5
+
+/// Ready threads of one priority, the running one first
+typedef struct kernel_list_t {
+    kernel_thread *head;
+    kernel_thread *tail;
+} kernel_list;
+
+/* Used by the port */
+kernel_thread *volatile kernelCurrent;
+kernel_thread *volatile kernelNext;
+
+static kernel_list readyLists[KERNEL_PRIORITIES];
+static volatile uint32_t readyMap;          //!< Bit n: readyLists[n] is not empty
+
+static kernel_thread idleThread;
+static uint64_t idleStack[KERNEL_IDLE_STACK_WORDS / 2];  //!< 64 bits for the alignment of the stack
+
+/* Ready lists. Everything below is called with interrupts masked. */
+
+static void ready_add(kernel_thread *thread, unsigned int first) {
+    kernel_list *list = &readyLists[thread->priority];
+
+    thread->state = STATE_READY;
+    if(!list->head) {
+        thread->next = 0;
+        list->head = thread;
+        list->tail = thread;
+    }
+    else if(first) {
+        thread->next = list->head;
+        list->head = thread;
+    }
+    else {
+        thread->next = 0;
+        list->tail->next = thread;
+        list->tail = thread;
+    }
+    readyMap |= 0x1UL << thread->priority;
+}
+
+static void ready_remove(kernel_thread *thread) {
+    kernel_list *list = &readyLists[thread->priority];
+    kernel_thread *previous = 0;
+    kernel_thread *walk = list->head;
+
+    while(walk != thread) {
+        previous = walk;
+        walk = walk->next;
+    }
+    if(previous) {
+        previous->next = thread->next;
+    }
+    else {
+        list->head = thread->next;
+    }
+    if(list->tail == thread) {
+        list->tail = previous;
+    }
+    if(!list->head) {
+        readyMap &= ~(0x1UL << thread->priority);
+    }
+    thread->next = 0;
+}
+
+/**
+ * Pends the switch to the highest priority ready thread if it is not the running one. The
+ * switch happens once interrupts are unmasked and no other handler is active.
+ */
+static void reschedule(void) {
+    kernel_thread *next;
+
+    if(!kernelCurrent) {
+        return;                             // Not started
+    }
+    // The idle thread is always ready: the map is never empty
+    next = readyLists[31 - __CLZ(readyMap)].head;
+    kernelNext = next;
+    if(next != kernelCurrent) {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
+
+/* Wait lists: highest priority first, first come first served within a priority */
+
+static void wait_add(kernel_thread **list, kernel_thread *thread) {
+    while(*list && (*list)->priority >= thread->priority) {
+        list = &(*list)->next;
+    }
+    thread->next = *list;
+    *list = thread;
+}
+
+static void wait_remove(kernel_thread **list, kernel_thread *thread) {
+    while(*list != thread) {
+        list = &(*list)->next;
+    }
+    *list = thread->next;
+    thread->next = 0;
+}
+
+static kernel_thread **wait_list_of(kernel_thread *thread) {
+    switch(thread->state) {
+    case STATE_MUTEX:
+        return &((kernel_mutex *)thread->waitingOn)->waiters;
+    case STATE_SENDING:
+        return &((kernel_queue *)thread->waitingOn)->senders;
+    case STATE_RECEIVING:
+        return &((kernel_queue *)thread->waitingOn)->receivers;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Ends the wait of a blocked thread, already out of its wait list
+ */
+static void wake(kernel_thread *thread, unsigned int result) {
+    SWTIMER_Stop(&thread->timeout);
+    thread->waitingOn = 0;
+    thread->result = result;
+    ready_add(thread, 0);
+}
+
+static void timeout_expired(swtimer *timer, void *ctx) {
+    kernel_thread *thread = (kernel_thread *)ctx;
+    kernel_thread **list;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    if(thread->state == STATE_SLEEPING) {
+        wake(thread, KERNEL_OPER_SUCCESS);
+        reschedule();
+    }
+    else if(thread->state == STATE_SENDING || thread->state == STATE_RECEIVING) {
+        list = wait_list_of(thread);
+        wait_remove(list, thread);
+        wake(thread, KERNEL_OPER_TIMEOUT);
+        reschedule();
+    }
+    CRITICAL_EXIT(state);
+}
+
+/**
+ * Blocks the running thread. Called with interrupts masked, the switch happens when the caller
+ * unmasks them.
+ *
+ * \param state STATE_xxx
+ * \param list Wait list to join, 0 for none
+ * \param timeoutMs KERNEL_WAIT_FOREVER for none
+ */
+static void block(unsigned int state, kernel_thread **list, unsigned int timeoutMs) {
+    kernel_thread *self = kernelCurrent;
+
+    ready_remove(self);
+    self->state = state;
+    if(list) {
+        wait_add(list, self);
+    }
+    if(timeoutMs != KERNEL_WAIT_FOREVER) {
+        SWTIMER_StartAt(&self->timeout, TIMER0_GetTicks64() + (uint64_t)timeoutMs * (TIMER_TICK_HZ / 1000));
+    }
+    reschedule();
+}
+
+/**
+ * Changes the effective priority of a thread, keeping its ready or wait list in order
+ */
+static void set_priority(kernel_thread *thread, unsigned int priority) {
+    kernel_thread **list;
+    unsigned int raised = priority > thread->priority;
+
+    if(priority == thread->priority) {
+        return;
+    }
+    if(thread->state == STATE_READY) {
+        ready_remove(thread);
+        thread->priority = priority;
+        // A raised thread goes first: it is holding up a higher priority one
+        ready_add(thread, raised);
+    }
+    else {
+        list = wait_list_of(thread);
+        if(list) {
+            wait_remove(list, thread);
+        }
+        thread->priority = priority;
+        if(list) {
+            wait_add(list, thread);
+        }
+    }
+}
+
+/**
+ * \return The priority a thread is owed: its own, or that of the first waiter of the mutexes
+ * it holds if higher
+ */
+static unsigned int inherited_priority(kernel_thread *thread) {
+    unsigned int priority = thread->basePriority;
+    kernel_mutex *mutex;
+
+    for(mutex = thread->mutexes; mutex; mutex = mutex->nextHeld) {
+        if(mutex->waiters && mutex->waiters->priority > priority) {
+            priority = mutex->waiters->priority;
+        }
+    }
+
+    return priority;
+}
+
+static void mutex_take(kernel_mutex *mutex, kernel_thread *thread) {
+    mutex->owner = thread;
+    mutex->count = 1;
+    mutex->nextHeld = thread->mutexes;
+    thread->mutexes = mutex;
+}
+
+static void mutex_release(kernel_mutex *mutex, kernel_thread *thread) {
+    kernel_mutex **held = &thread->mutexes;
+
+    while(*held != mutex) {
+        held = &(*held)->nextHeld;
+    }
+    *held = mutex->nextHeld;
+    mutex->nextHeld = 0;
+}
+
+static void idle(void *arg) {
+    for(;;) {
+        __WFI();
+    }
+}
+
+/**
+ * Where a thread goes when its function returns
+ */
+static void thread_end(void) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    ready_remove(kernelCurrent);
+    kernelCurrent->state = STATE_ENDED;
+    reschedule();
+    CRITICAL_EXIT(state);
+    for(;;);
+}
+
+/**
+ * Time slice: the running thread goes behind the other ready ones of its priority
+ */
+static void kernel_slice(void) {
+    kernel_thread *self = kernelCurrent;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    if(self && self->state == STATE_READY && readyLists[self->priority].head == self && self->next) {
+        ready_remove(self);
+        ready_add(self, 0);
+        reschedule();
+    }
+    CRITICAL_EXIT(state);
+}
+
+/**
+ * Prepares a thread to be switched to as if it had been preempted at the start of 'entry'
+ */
+static void thread_setup(kernel_thread *thread, uint32_t *stack, unsigned int stackWords,
+                         kernel_entry entry, void *arg, unsigned int priority) {
+    thread->sp = KERNEL_PortInitStack(stack, stackWords, entry, arg, thread_end);
+    thread->stack = stack;
+    thread->stackWords = stackWords;
+    thread->priority = priority;
+    thread->basePriority = priority;
+    thread->waitingOn = 0;
+    thread->message = 0;
+    thread->mutexes = 0;
+    thread->result = KERNEL_OPER_SUCCESS;
+    SWTIMER_Setup(&thread->timeout, timeout_expired, thread);
+}
+
+void KERNEL_Init(void) {
+    unsigned int priority;
+
+    for(priority = 0; priority < KERNEL_PRIORITIES; priority++) {
+        readyLists[priority].head = 0;
+        readyLists[priority].tail = 0;
+    }
+    readyMap = 0;
+    kernelCurrent = 0;
+    kernelNext = 0;
+
+    thread_setup(&idleThread, (uint32_t *)idleStack, KERNEL_IDLE_STACK_WORDS, idle, 0, 0);
+    ready_add(&idleThread, 0);
+}
+
+unsigned int KERNEL_CreateThread(kernel_thread *thread, uint32_t *stack, unsigned int stackWords,
+                                 kernel_entry entry, void *arg, unsigned int priority) {
+    uint32_t state;
+
+    if(!priority || priority >= KERNEL_PRIORITIES || stackWords < KERNEL_MIN_STACK_WORDS) {
+        return KERNEL_OPER_FAIL;
+    }
+    thread_setup(thread, stack, stackWords, entry, arg, priority);
+
+    CRITICAL_ENTER(state);
+    ready_add(thread, 0);
+    reschedule();
+    CRITICAL_EXIT(state);
+
+    return KERNEL_OPER_SUCCESS;
+}
+
+void KERNEL_Start(void) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    kernelNext = readyLists[31 - __CLZ(readyMap)].head;
+    CRITICAL_EXIT(state);
+
+    KERNEL_PortStart(kernel_slice);
+}
+
+kernel_thread *KERNEL_Self(void) {
+    return kernelCurrent;
+}
+
+void KERNEL_Yield(void) {
+    kernel_thread *self = kernelCurrent;
+    uint32_t state;
+
+    if(!self) {
+        return;
+    }
+    CRITICAL_ENTER(state);
+    ready_remove(self);
+    ready_add(self, 0);
+    reschedule();
+    CRITICAL_EXIT(state);
+}
+
+void KERNEL_Sleep(unsigned int ms) {
+    uint32_t state;
+
+    if(!ms || !kernelCurrent) {
+        KERNEL_Yield();
+        return;
+    }
+    CRITICAL_ENTER(state);
+    block(STATE_SLEEPING, 0, ms);
+    CRITICAL_EXIT(state);
+}
+
+void KERNEL_MutexInit(kernel_mutex *mutex) {
+    mutex->owner = 0;
+    mutex->waiters = 0;
+    mutex->nextHeld = 0;
+    mutex->count = 0;
+}
+
+unsigned int KERNEL_MutexLock(kernel_mutex *mutex) {
+    kernel_thread *self = kernelCurrent;
+    kernel_thread *owner;
+    uint32_t state;
+
+    if(!self) {
+        return KERNEL_OPER_FAIL;
+    }
+    CRITICAL_ENTER(state);
+    if(!mutex->owner) {
+        mutex_take(mutex, self);
+    }
+    else if(mutex->owner == self) {
+        mutex->count++;
+    }
+    else {
+        self->waitingOn = mutex;
+        block(STATE_MUTEX, &mutex->waiters, KERNEL_WAIT_FOREVER);
+
+        // The owner, and whoever it waits for in turn, runs at least at our priority
+        owner = mutex->owner;
+        while(owner && owner->priority < self->priority) {
+            set_priority(owner, self->priority);
+            if(owner->state != STATE_MUTEX) {
+                break;
+            }
+            owner = ((kernel_mutex *)owner->waitingOn)->owner;
+        }
+        reschedule();
+    }
+    CRITICAL_EXIT(state);
+    // Once woken up the mutex has been handed over by KERNEL_MutexUnlock()
+
+    return KERNEL_OPER_SUCCESS;
+}
+
+unsigned int KERNEL_MutexUnlock(kernel_mutex *mutex) {
+    kernel_thread *self = kernelCurrent;
+    kernel_thread *waiter;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    if(!self || mutex->owner != self || !mutex->count) {
+        CRITICAL_EXIT(state);
+        return KERNEL_OPER_FAIL;
+    }
+    if(--mutex->count) {
+        CRITICAL_EXIT(state);
+        return KERNEL_OPER_SUCCESS;
+    }
+
+    mutex_release(mutex, self);
+    waiter = mutex->waiters;
+    if(waiter) {
+        // Handed to the first waiter directly, nobody can take it in between
+        mutex->waiters = waiter->next;
+        mutex_take(mutex, waiter);
+        wake(waiter, KERNEL_OPER_SUCCESS);
+        set_priority(waiter, inherited_priority(waiter));
+    }
+    else {
+        mutex->owner = 0;
+    }
+    set_priority(self, inherited_priority(self));
+    reschedule();
+    CRITICAL_EXIT(state);
+
+    return KERNEL_OPER_SUCCESS;
+}
+
+unsigned int KERNEL_QueueInit(kernel_queue *queue, void *buffer, unsigned int itemSize, unsigned int capacity) {
+    if(!capacity) {
+        return KERNEL_OPER_FAIL;
+    }
+    queue->buffer = (uint8_t *)buffer;
+    queue->itemSize = itemSize;
+    queue->capacity = capacity;
+    queue->count = 0;
+    queue->head = 0;
+    queue->senders = 0;
+    queue->receivers = 0;
+
+    return KERNEL_OPER_SUCCESS;
+}
+
+/**
+ * Copies an item in: to a waiting receiver, else at the back of the queue.
+ * Called with interrupts masked.
+ *
+ * \return Command's result, fails if the queue is full
+ */
+static unsigned int queue_put(kernel_queue *queue, const void *item) {
+    kernel_thread *receiver = queue->receivers;
+    unsigned int tail;
+
+    if(receiver) {
+        queue->receivers = receiver->next;
+        memcpy(receiver->message, item, queue->itemSize);
+        wake(receiver, KERNEL_OPER_SUCCESS);
+        return KERNEL_OPER_SUCCESS;
+    }
+    if(queue->count == queue->capacity) {
+        return KERNEL_OPER_FAIL;
+    }
+    tail = queue->head + queue->count;
+    if(tail >= queue->capacity) {
+        tail -= queue->capacity;
+    }
+    memcpy(queue->buffer + tail * queue->itemSize, item, queue->itemSize);
+    queue->count++;
+
+    return KERNEL_OPER_SUCCESS;
+}
+
+unsigned int KERNEL_QueueSend(kernel_queue *queue, const void *item, unsigned int timeoutMs) {
+    kernel_thread *self = kernelCurrent;
+    unsigned int result;
+    uint32_t state;
+
+    if(!self) {
+        return KERNEL_OPER_FAIL;
+    }
+    CRITICAL_ENTER(state);
+    result = queue_put(queue, item);
+    if(result == KERNEL_OPER_SUCCESS) {
+        reschedule();
+        CRITICAL_EXIT(state);
+        return result;
+    }
+    if(!timeoutMs) {
+        CRITICAL_EXIT(state);
+        return KERNEL_OPER_TIMEOUT;
+    }
+    // KERNEL_QueueReceive() moves the item in when it makes room
+    self->message = (void *)item;
+    self->waitingOn = queue;
+    block(STATE_SENDING, &queue->senders, timeoutMs);
+    CRITICAL_EXIT(state);
+
+    return self->result;
+}
+
+unsigned int KERNEL_QueueSendFromISR(kernel_queue *queue, const void *item) {
+    unsigned int result;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    result = queue_put(queue, item);
+    reschedule();
+    CRITICAL_EXIT(state);
+
+    return result;
+}
+
+unsigned int KERNEL_QueueReceive(kernel_queue *queue, void *item, unsigned int timeoutMs) {
+    kernel_thread *self = kernelCurrent;
+    kernel_thread *sender;
+    uint32_t state;
+
+    if(!self) {
+        return KERNEL_OPER_FAIL;
+    }
+    CRITICAL_ENTER(state);
+    if(queue->count) {
+        memcpy(item, queue->buffer + queue->head * queue->itemSize, queue->itemSize);
+        if(++queue->head == queue->capacity) {
+            queue->head = 0;
+        }
+        queue->count--;
+
+        sender = queue->senders;
+        if(sender) {
+            queue->senders = sender->next;
+            queue_put(queue, sender->message);
+            wake(sender, KERNEL_OPER_SUCCESS);
+        }
+        reschedule();
+        CRITICAL_EXIT(state);
+        return KERNEL_OPER_SUCCESS;
+    }
+    if(!timeoutMs) {
+        CRITICAL_EXIT(state);
+        return KERNEL_OPER_TIMEOUT;
+    }
+    // queue_put() copies the item straight here
+    self->message = item;
+    self->waitingOn = queue;
+    block(STATE_RECEIVING, &queue->receivers, timeoutMs);
+    CRITICAL_EXIT(state);
+
+    return self->result;
+}
+
+/* Hooks of the drivers written for a host scheduler (ethernet_drv.c), in place of those of the
+   cooperative scheduler: from a thread they block it, before KERNEL_Start() they fall back. */
+
+void DelayPort(unsigned int ms) {
+    if(kernelCurrent) {
+        KERNEL_Sleep(ms);
+    }
+    else {
+        SCHED_Delay(ms);
+    }
+}
+
+void YieldPort(void) {
+    if(kernelCurrent) {
+        KERNEL_Yield();
+    }
+    else {
+        SCHED_Yield();
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file     kernel_cm3.c
+ * @brief    Cortex-M3 port of the preemptive kernel: initial stack frames and start.
+ *           The context switch itself is in kernel_port.s.
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "kernel_port.h"
+#include "systick_drv.h"
+#include "common.h"
+
+#define XPSR_THUMB                          0x01000000
+#define LOWEST_EXCEPTION_PRIORITY           ((0x1 << __NVIC_PRIO_BITS) - 1)
+
+uint32_t *KERNEL_PortInitStack(uint32_t *stack, unsigned int stackWords, kernel_entry entry, void *arg,
+                               void (*end)(void)) {
+    uint32_t *sp;
+
+    // Exception frame as if 'entry' had been interrupted, then R4 to R11 as PendSV saves them
+    sp = (uint32_t *)((uint32_t)(stack + stackWords) & ~0x7);
+    *--sp = XPSR_THUMB;
+    *--sp = (uint32_t)entry & ~0x1;         // PC, the Thumb bit is in xPSR
+    *--sp = (uint32_t)end;                  // LR
+    sp -= 4;                                // R12, R3, R2, R1
+    *--sp = (uint32_t)arg;                  // R0
+    sp -= 8;                                // R11 to R4
+
+    return sp;
+}
+
+void KERNEL_PortStart(void (*slice)(void)) {
+    uint32_t state;
+
+    // Switches only once every other handler is done; the slice never preempts one either
+    NVIC_SetPriority(PendSV_IRQn, LOWEST_EXCEPTION_PRIORITY);
+    NVIC_SetPriority(SysTick_IRQn, LOWEST_EXCEPTION_PRIORITY);
+    SYSTICK_SetCallback(slice);
+    SYSTICK_Init(SystemCoreClock / 1000 * KERNEL_SLICE_MS);
+
+    CRITICAL_ENTER(state);
+    // PendSV sees no current thread: the main context is dropped, not saved
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    CRITICAL_EXIT(state);
+
+    for(;;);
+}
@@ -0,0 +1,45 @@
+/**************************************************
+ *
+ * Context switch of the preemptive kernel (kernel.c)
+ *
+ * PendSV is pended by the kernel whenever kernelNext is not the running thread.
+ * It runs at the lowest exception priority, once every other handler is done,
+ * so a thread is always switched from thread mode with its exception frame
+ * (R0-R3, R12, LR, PC, xPSR) already on its process stack. The handler adds
+ * R4-R11 below it and keeps the resulting stack pointer in the first field
+ * of the thread, kernel_thread.sp, then does the reverse for the next thread.
+ *
+ * The first switch is made from main(): with no current thread nothing is
+ * saved, the main stack is left to the handlers.
+ *
+ **************************************************/
+
+        MODULE  ?kernel_port
+
+        EXTERN  kernelCurrent
+        EXTERN  kernelNext
+        PUBLIC  PendSV_Handler
+
+        SECTION .text:CODE:NOROOT(2)
+        THUMB
+
+PendSV_Handler
+        CPSID   I
+        LDR     R2, =kernelCurrent
+        LDR     R0, [R2]
+        CBZ     R0, restore
+        MRS     R1, PSP
+        STMDB   R1!, {R4-R11}
+        STR     R1, [R0]                    ; kernelCurrent->sp
+restore
+        LDR     R3, =kernelNext
+        LDR     R0, [R3]
+        STR     R0, [R2]                    ; kernelCurrent = kernelNext
+        LDR     R1, [R0]                    ; kernelNext->sp
+        LDMIA   R1!, {R4-R11}
+        MSR     PSP, R1
+        ORR     LR, LR, #4                  ; Return to thread mode on the process stack
+        CPSIE   I
+        BX      LR
+
+        END
@@ -0,0 +1,344 @@
+/**
+ * @file     kvstore.c
+ * @brief    EEPROM key/value store
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <string.h>
+#include "kvstore.h"
+#include "crc.h"
+
+/* Bank header: magic, generation, reserved, crc */
+#define KVS_MAGIC                   0x4B56
+#define KVS_HEADER_SIZE             8
+/* Record: generation, key, size, value, crc */
+#define KVS_RECORD_HEAD_SIZE        5
+#define KVS_RECORD_OVERHEAD         (KVS_RECORD_HEAD_SIZE + 2)
+#define KVS_RECORD_MAX_SIZE         (KVS_RECORD_OVERHEAD + KVS_MAX_VALUE_SIZE)
+
+#define BANK_ADDR(bank)             (KVS_BASE_ADDR + (bank) * KVS_BANK_SIZE)
+#define GEN_IS_NEWER(a, b)          ((int16_t)(uint16_t)((a) - (b)) > 0)
+
+// Every live value must fit in a freshly compacted bank
+typedef char kvs_geometry_check[(KVS_HEADER_SIZE + KVS_MAX_KEYS * KVS_RECORD_MAX_SIZE <= KVS_BANK_SIZE)? 1 : -1];
+
+/// RAM copy of a stored value
+typedef struct kvs_entry_t {
+    uint16_t key;
+    uint8_t size;
+    uint8_t value[KVS_MAX_VALUE_SIZE];
+} kvs_entry;
+
+static kvs_entry entries[KVS_MAX_KEYS];
+static unsigned int activeBank;
+static uint16_t generation;
+static unsigned int writeOffset;
+
+
+static void put_u16(uint8_t *buf, uint16_t val) {
+    buf[0] = val & 0xFF;
+    buf[1] = val >> 8;
+}
+
+static uint16_t get_u16(const uint8_t *buf) {
+    return buf[0] | (buf[1] << 8);
+}
+
+static kvs_entry *entry_find(uint16_t key) {
+    int i;
+    for(i = 0; i < KVS_MAX_KEYS; i++) {
+        if(entries[i].key == key) {
+            return &entries[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * Applies a value to the RAM index. A zero size removes the key.
+ */
+static unsigned int entry_update(uint16_t key, const void *value, unsigned int size) {
+    kvs_entry *entry = entry_find(key);
+    if(size == 0) {
+        if(entry) {
+            entry->key = KVS_INVALID_KEY;
+        }
+        return KVS_OPER_SUCCESS;
+    }
+
+    if(!entry) {
+        entry = entry_find(KVS_INVALID_KEY);
+        if(!entry) {
+            return KVS_NO_SPACE;
+        }
+    }
+    entry->key = key;
+    entry->size = size;
+    memcpy(entry->value, value, size);
+
+    return KVS_OPER_SUCCESS;
+}
+
+static unsigned int read_header(unsigned int bank, uint16_t *gen) {
+    uint8_t header[KVS_HEADER_SIZE];
+
+    if(FLASH_ReadData(header, (void *)BANK_ADDR(bank), KVS_HEADER_SIZE) != FLASH_OPER_SUCCESS) {
+        return KVS_OPER_FAIL;
+    }
+    if(get_u16(&header[0]) != KVS_MAGIC ||
+       get_u16(&header[6]) != CRC16_Update(CRC16_INIT, header, 6)) {
+        return KVS_NOT_FOUND;
+    }
+    *gen = get_u16(&header[2]);
+
+    return KVS_OPER_SUCCESS;
+}
+
+static unsigned int write_header(unsigned int bank, uint16_t gen) {
+    uint8_t header[KVS_HEADER_SIZE];
+
+    put_u16(&header[0], KVS_MAGIC);
+    put_u16(&header[2], gen);
+    put_u16(&header[4], 0xFFFF);
+    put_u16(&header[6], CRC16_Update(CRC16_INIT, header, 6));
+
+    if(FLASH_WriteData((void *)BANK_ADDR(bank), header, KVS_HEADER_SIZE) != FLASH_OPER_SUCCESS ||
+       FLASH_Flush() != FLASH_OPER_SUCCESS) {
+        return KVS_OPER_FAIL;
+    }
+
+    return KVS_OPER_SUCCESS;
+}
+
+static unsigned int encode_record(uint8_t *buf, uint16_t gen, uint16_t key, const void *value, unsigned int size) {
+    put_u16(&buf[0], gen);
+    put_u16(&buf[2], key);
+    buf[4] = size;
+    if(size > 0) {
+        memcpy(&buf[KVS_RECORD_HEAD_SIZE], value, size);
+    }
+    put_u16(&buf[KVS_RECORD_HEAD_SIZE + size], CRC16_Update(CRC16_INIT, buf, KVS_RECORD_HEAD_SIZE + size));
+
+    return KVS_RECORD_OVERHEAD + size;
+}
+
+/**
+ * Ends the log: a record head reading as erased. What follows in the bank, from an earlier
+ * use of it, may hold records of the same generation and must not be replayed.
+ *
+ * \return Bytes of the terminator, 0 when the log reaches the end of the bank
+ */
+static unsigned int encode_terminator(uint8_t *buf, unsigned int offset) {
+    if(offset + KVS_RECORD_OVERHEAD > KVS_BANK_SIZE) {
+        return 0;
+    }
+    memset(buf, 0xFF, KVS_RECORD_HEAD_SIZE);
+
+    return KVS_RECORD_HEAD_SIZE;
+}
+
+/**
+ * Terminates the log of a bank at 'offset' and then, once that is on the EEPROM, writes the header
+ * that makes the bank valid
+ */
+static unsigned int write_log_end(unsigned int bank, uint16_t gen, unsigned int offset) {
+    uint8_t terminator[KVS_RECORD_HEAD_SIZE];
+    unsigned int len = encode_terminator(terminator, offset);
+
+    if((len && FLASH_WriteData((void *)(BANK_ADDR(bank) + offset), terminator, len) != FLASH_OPER_SUCCESS) ||
+       FLASH_Flush() != FLASH_OPER_SUCCESS) {
+        return KVS_OPER_FAIL;
+    }
+
+    return write_header(bank, gen);
+}
+
+/**
+ * Writes a record at the end of the active bank, followed by a terminator, and makes it durable.
+ * The write offset only moves once the record is on the EEPROM, so a failed
+ * record is overwritten by the next one.
+ */
+static unsigned int append_record(uint16_t key, const void *value, unsigned int size) {
+    uint8_t record[KVS_RECORD_MAX_SIZE + KVS_RECORD_HEAD_SIZE];
+    unsigned int len = encode_record(record, generation, key, value, size);
+
+    if(writeOffset + len > KVS_BANK_SIZE) {
+        return KVS_NO_SPACE;
+    }
+    len += encode_terminator(&record[len], writeOffset + len);
+    if(FLASH_WriteData((void *)(BANK_ADDR(activeBank) + writeOffset), record, len) != FLASH_OPER_SUCCESS ||
+       FLASH_Flush() != FLASH_OPER_SUCCESS) {
+        return KVS_OPER_FAIL;
+    }
+    writeOffset += KVS_RECORD_OVERHEAD + size;
+
+    return KVS_OPER_SUCCESS;
+}
+
+static unsigned int append_or_compact(uint16_t key, const void *value, unsigned int size) {
+    unsigned int retVal = append_record(key, value, size);
+    if(retVal != KVS_NO_SPACE) {
+        return retVal;
+    }
+
+    retVal = KVS_Compact();
+    if(retVal != KVS_OPER_SUCCESS) {
+        return retVal;
+    }
+    return append_record(key, value, size);
+}
+
+/**
+ * Replays the log of the active bank into the RAM index. The log ends at the first record
+ * that is blank, belongs to another generation or fails its CRC.
+ */
+static unsigned int scan_bank(void) {
+    uint8_t record[KVS_RECORD_MAX_SIZE];
+    unsigned int offset = KVS_HEADER_SIZE;
+    unsigned int size;
+    uint16_t key;
+
+    while(offset + KVS_RECORD_OVERHEAD <= KVS_BANK_SIZE) {
+        if(FLASH_ReadData(record, (void *)(BANK_ADDR(activeBank) + offset), KVS_RECORD_HEAD_SIZE) != FLASH_OPER_SUCCESS) {
+            return KVS_OPER_FAIL;
+        }
+
+        key = get_u16(&record[2]);
+        size = record[4];
+        if(get_u16(&record[0]) != generation || key == KVS_INVALID_KEY ||
+           size > KVS_MAX_VALUE_SIZE || offset + KVS_RECORD_OVERHEAD + size > KVS_BANK_SIZE) {
+            break;
+        }
+
+        if(FLASH_ReadData(&record[KVS_RECORD_HEAD_SIZE], (void *)(BANK_ADDR(activeBank) + offset + KVS_RECORD_HEAD_SIZE), size + 2) != FLASH_OPER_SUCCESS) {
+            return KVS_OPER_FAIL;
+        }
+        if(get_u16(&record[KVS_RECORD_HEAD_SIZE + size]) != CRC16_Update(CRC16_INIT, record, KVS_RECORD_HEAD_SIZE + size)) {
+            break;
+        }
+
+        if(entry_update(key, &record[KVS_RECORD_HEAD_SIZE], size) != KVS_OPER_SUCCESS) {
+            return KVS_NO_SPACE;
+        }
+        offset += KVS_RECORD_OVERHEAD + size;
+    }
+    writeOffset = offset;
+
+    return KVS_OPER_SUCCESS;
+}
+
+unsigned int KVS_Init(void) {
+    uint16_t gen[2];
+    unsigned int found[2];
+    int i;
+
+    for(i = 0; i < KVS_MAX_KEYS; i++) {
+        entries[i].key = KVS_INVALID_KEY;
+    }
+
+    for(i = 0; i < 2; i++) {
+        found[i] = read_header(i, &gen[i]);
+        if(found[i] == KVS_OPER_FAIL) {
+            return KVS_OPER_FAIL;
+        }
+    }
+
+    if(found[0] != KVS_OPER_SUCCESS && found[1] != KVS_OPER_SUCCESS) {
+        // Blank or corrupted region: format. Old records of generation 1 may remain.
+        activeBank = 0;
+        generation = 1;
+        writeOffset = KVS_HEADER_SIZE;
+        return write_log_end(activeBank, generation, writeOffset);
+    }
+
+    if(found[0] == KVS_OPER_SUCCESS && (found[1] != KVS_OPER_SUCCESS || !GEN_IS_NEWER(gen[1], gen[0]))) {
+        activeBank = 0;
+    }
+    else {
+        activeBank = 1;
+    }
+    generation = gen[activeBank];
+
+    return scan_bank();
+}
+
+unsigned int KVS_Get(uint16_t key, void *value, unsigned int *size) {
+    kvs_entry *entry = entry_find(key);
+    if(key == KVS_INVALID_KEY || !entry) {
+        return KVS_NOT_FOUND;
+    }
+    if(*size < entry->size) {
+        return KVS_OPER_FAIL;
+    }
+
+    memcpy(value, entry->value, entry->size);
+    *size = entry->size;
+
+    return KVS_OPER_SUCCESS;
+}
+
+unsigned int KVS_Set(uint16_t key, const void *value, unsigned int size) {
+    if(key == KVS_INVALID_KEY || size == 0 || size > KVS_MAX_VALUE_SIZE) {
+        return KVS_OPER_FAIL;
+    }
+
+    kvs_entry *entry = entry_find(key);
+    if(entry && entry->size == size && memcmp(entry->value, value, size) == 0) {
+        return KVS_OPER_SUCCESS;
+    }
+    if(!entry && !entry_find(KVS_INVALID_KEY)) {
+        return KVS_NO_SPACE;
+    }
+
+    unsigned int retVal = append_or_compact(key, value, size);
+    if(retVal != KVS_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    return entry_update(key, value, size);
+}
+
+unsigned int KVS_Delete(uint16_t key) {
+    if(key == KVS_INVALID_KEY || !entry_find(key)) {
+        return KVS_NOT_FOUND;
+    }
+
+    unsigned int retVal = append_or_compact(key, 0, 0);
+    if(retVal != KVS_OPER_SUCCESS) {
+        return retVal;
+    }
+
+    return entry_update(key, 0, 0);
+}
+
+unsigned int KVS_Compact(void) {
+    uint8_t record[KVS_RECORD_MAX_SIZE];
+    unsigned int newBank = activeBank ^ 1;
+    uint16_t newGen = generation + 1;
+    unsigned int offset = KVS_HEADER_SIZE;
+    unsigned int len;
+    int i;
+
+    // Records first; the old bank stays the valid one until the new header lands
+    for(i = 0; i < KVS_MAX_KEYS; i++) {
+        if(entries[i].key == KVS_INVALID_KEY) {
+            continue;
+        }
+        len = encode_record(record, newGen, entries[i].key, entries[i].value, entries[i].size);
+        if(FLASH_WriteData((void *)(BANK_ADDR(newBank) + offset), record, len) != FLASH_OPER_SUCCESS) {
+            return KVS_OPER_FAIL;
+        }
+        offset += len;
+    }
+    if(write_log_end(newBank, newGen, offset) != KVS_OPER_SUCCESS) {
+        return KVS_OPER_FAIL;
+    }
+
+    activeBank = newBank;
+    generation = newGen;
+    writeOffset = offset;
+
+    return KVS_OPER_SUCCESS;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file     lcd_fb.c
+ * @brief    LCD framebuffer: dirty rectangles flushed to the PCF8833 panel on DMA
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "lcd_fb.h"
+#include "gpio_drv.h"
+#include "common.h"
+#include "main.h"
+
+/* PCF8833 commands. 9-bit frames: bit 8 is clear for a command and set for its parameters */
+#define LCD_DATA                            0x100
+#define LCD_SLEEPOUT                        0x11
+#define LCD_DISPON                          0x29
+#define LCD_CASET                           0x2A
+#define LCD_PASET                           0x2B
+#define LCD_RAMWR                           0x2C
+#define LCD_RGBSET                          0x2D
+#define LCD_MADCTL                          0x36
+#define LCD_COLMOD                          0x3A
+#define LCD_SETCON                          0x25
+#define LCD_COLMOD_8BPP                     0x02
+
+#define WINDOW_WORDS                        7                   // CASET x0 x1 PASET y0 y1 RAMWR
+
+/// Inclusive bounds
+typedef struct lcd_rect_t {
+    uint8_t x0;
+    uint8_t y0;
+    uint8_t x1;
+    uint8_t y1;
+} lcd_rect;
+
+static uint8_t frame[LCD_FB_HEIGHT][LCD_FB_WIDTH];
+static lcd_rect dirty[LCD_FB_MAX_DIRTY];
+static unsigned int dirtyCount;
+
+// Flush state, owned by the DMA interrupt while a flush runs
+static lcd_rect flushRects[LCD_FB_MAX_DIRTY];
+static unsigned int flushCount;
+static unsigned int flushIndex;
+static unsigned int flushX;
+static unsigned int flushY;
+static unsigned char windowSent;
+static unsigned int inFlight;
+static volatile unsigned char flushing;
+
+static uint16_t staging[2][LCD_FB_STAGING_WORDS];
+static spi_transaction chunks[2];
+static spi_bus_device lcdDevice;
+
+/* RGB332 to the panel's 4-bit levels: 8 red, 8 green, 4 blue. Not const: sent by DMA, from RAM */
+static uint16_t rgbTable[] = {
+    LCD_RGBSET,
+    LCD_DATA | 0, LCD_DATA | 2, LCD_DATA | 4, LCD_DATA | 6, LCD_DATA | 9, LCD_DATA | 11, LCD_DATA | 13, LCD_DATA | 15,
+    LCD_DATA | 0, LCD_DATA | 2, LCD_DATA | 4, LCD_DATA | 6, LCD_DATA | 9, LCD_DATA | 11, LCD_DATA | 13, LCD_DATA | 15,
+    LCD_DATA | 0, LCD_DATA | 4, LCD_DATA | 11, LCD_DATA | 15
+};
+
+static void lcd_send(const uint16_t *words, unsigned int count) {
+    SPIBUS_Select(&lcdDevice);
+    SPIBUS_Exchange(&lcdDevice, words, 0, count);
+    SPIBUS_Deselect(&lcdDevice);
+}
+
+static void lcd_command(uint16_t command, int parameter) {
+    uint16_t words[2];
+
+    words[0] = command;
+    words[1] = LCD_DATA | (parameter & 0xFF);
+    lcd_send(words, (parameter < 0)? 1 : 2);
+}
+
+unsigned int LCDFB_Init(void) {
+    lcdDevice.port = LCD_FB_SSP_PORT;
+    lcdDevice.csPort = LCD_FB_CS_PORT;
+    lcdDevice.csPin = LCD_FB_CS_PIN;
+    lcdDevice.mode = SSP_MODE_0;
+    lcdDevice.bitData = 9;
+    lcdDevice.frequency = LCD_FB_FREQUENCY;
+    lcdDevice.csSetupNs = 100;
+    lcdDevice.csHoldNs = 100;
+    if(SPIBUS_AddDevice(&lcdDevice) != SPIBUS_OPER_SUCCESS) {
+        return LCD_FB_OPER_FAIL;
+    }
+
+    GPIO_PORT(LCD_FB_BL_PORT)->FIOCLR = LCD_BL_MASK;
+    GPIO_PORT(LCD_FB_BL_PORT)->FIODIR |= LCD_BL_MASK;
+    GPIO_PORT(LCD_FB_RST_PORT)->FIOCLR = LCD_RST_MASK;
+    GPIO_PORT(LCD_FB_RST_PORT)->FIODIR |= LCD_RST_MASK;
+    Delay(10);
+    GPIO_PORT(LCD_FB_RST_PORT)->FIOSET = LCD_RST_MASK;
+    Delay(10);
+
+    lcd_command(LCD_SLEEPOUT, -1);
+    Delay(10);
+    lcd_command(LCD_COLMOD, LCD_COLMOD_8BPP);
+    lcd_command(LCD_MADCTL, LCD_FB_MADCTL);
+    lcd_command(LCD_SETCON, LCD_FB_CONTRAST);
+    lcd_send(rgbTable, sizeof(rgbTable) / sizeof(rgbTable[0]));
+
+    dirtyCount = 0;
+    LCDFB_FillRect(0, 0, LCD_FB_WIDTH, LCD_FB_HEIGHT, LCD_BLACK);
+    LCDFB_Flush();
+    while(flushing);
+
+    lcd_command(LCD_DISPON, -1);
+    GPIO_PORT(LCD_FB_BL_PORT)->FIOSET = LCD_BL_MASK;
+
+    return LCD_FB_OPER_SUCCESS;
+}
+
+uint8_t *LCDFB_GetBuffer(void) {
+    return &frame[0][0];
+}
+
+static unsigned int rect_area(const lcd_rect *r) {
+    return (r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+}
+
+static void rect_union(lcd_rect *dst, const lcd_rect *a, const lcd_rect *b) {
+    dst->x0 = (a->x0 < b->x0)? a->x0 : b->x0;
+    dst->y0 = (a->y0 < b->y0)? a->y0 : b->y0;
+    dst->x1 = (a->x1 > b->x1)? a->x1 : b->x1;
+    dst->y1 = (a->y1 > b->y1)? a->y1 : b->y1;
+}
+
+/**
+ * \return Pixels 'a' and 'b' would send needlessly if they were merged. Each rectangle costs a
+ * window set up, so merging is worth it below that.
+ */
+static int merge_cost(const lcd_rect *a, const lcd_rect *b) {
+    lcd_rect u;
+
+    rect_union(&u, a, b);
+    return (int)rect_area(&u) - (int)rect_area(a) - (int)rect_area(b);
+}
+
+void LCDFB_Invalidate(int x, int y, int width, int height) {
+    lcd_rect r;
+    unsigned int i, best;
+    int cost, bestCost;
+
+    if(x < 0) {
+        width += x;
+        x = 0;
+    }
+    if(y < 0) {
+        height += y;
+        y = 0;
+    }
+    if(x + width > LCD_FB_WIDTH) {
+        width = LCD_FB_WIDTH - x;
+    }
+    if(y + height > LCD_FB_HEIGHT) {
+        height = LCD_FB_HEIGHT - y;
+    }
+    if(width <= 0 || height <= 0) {
+        return;
+    }
+    r.x0 = x;
+    r.y0 = y;
+    r.x1 = x + width - 1;
+    r.y1 = y + height - 1;
+
+    // Absorb every rectangle that is cheap to merge with; a merge may make others cheap too
+    i = 0;
+    while(i < dirtyCount) {
+        if(merge_cost(&r, &dirty[i]) <= WINDOW_WORDS) {
+            rect_union(&r, &r, &dirty[i]);
+            dirty[i] = dirty[--dirtyCount];
+            i = 0;
+        }
+        else {
+            i++;
+        }
+    }
+
+    if(dirtyCount < LCD_FB_MAX_DIRTY) {
+        dirty[dirtyCount++] = r;
+        return;
+    }
+
+    // Full: grow the rectangle that costs the least to merge with
+    best = 0;
+    bestCost = merge_cost(&r, &dirty[0]);
+    for(i = 1; i < dirtyCount; i++) {
+        cost = merge_cost(&r, &dirty[i]);
+        if(cost < bestCost) {
+            bestCost = cost;
+            best = i;
+        }
+    }
+    rect_union(&dirty[best], &dirty[best], &r);
+}
+
+void LCDFB_SetPixel(int x, int y, uint8_t color) {
+    if(x < 0 || y < 0 || x >= LCD_FB_WIDTH || y >= LCD_FB_HEIGHT) {
+        return;
+    }
+    frame[y][x] = color;
+    LCDFB_Invalidate(x, y, 1, 1);
+}
+
+void LCDFB_FillRect(int x, int y, int width, int height, uint8_t color) {
+    int row, column;
+
+    if(x < 0) {
+        width += x;
+        x = 0;
+    }
+    if(y < 0) {
+        height += y;
+        y = 0;
+    }
+    if(x + width > LCD_FB_WIDTH) {
+        width = LCD_FB_WIDTH - x;
+    }
+    if(y + height > LCD_FB_HEIGHT) {
+        height = LCD_FB_HEIGHT - y;
+    }
+    if(width <= 0 || height <= 0) {
+        return;
+    }
+
+    for(row = y; row < y + height; row++) {
+        for(column = x; column < x + width; column++) {
+            frame[row][column] = color;
+        }
+    }
+    LCDFB_Invalidate(x, y, width, height);
+}
+
+/**
+ * Fills a staging buffer with the next window set up and pixels, rows being split anywhere:
+ * RAMWR carries on across transfers as the chip select is kept asserted.
+ *
+ * \return Number of words, 0 once everything has been staged
+ */
+static unsigned int flush_fill(uint16_t *words) {
+    unsigned int count = 0;
+    unsigned int run, i;
+    const lcd_rect *r;
+    const uint8_t *pixel;
+
+    while(flushIndex < flushCount && count < LCD_FB_STAGING_WORDS) {
+        r = &flushRects[flushIndex];
+        if(!windowSent) {
+            if(count + WINDOW_WORDS > LCD_FB_STAGING_WORDS) {
+                break;
+            }
+            words[count++] = LCD_CASET;
+            words[count++] = LCD_DATA | r->x0;
+            words[count++] = LCD_DATA | r->x1;
+            words[count++] = LCD_PASET;
+            words[count++] = LCD_DATA | r->y0;
+            words[count++] = LCD_DATA | r->y1;
+            words[count++] = LCD_RAMWR;
+            flushX = r->x0;
+            flushY = r->y0;
+            windowSent = 1;
+        }
+
+        while(count < LCD_FB_STAGING_WORDS && flushY <= r->y1) {
+            run = r->x1 + 1 - flushX;
+            if(run > LCD_FB_STAGING_WORDS - count) {
+                run = LCD_FB_STAGING_WORDS - count;
+            }
+            pixel = &frame[flushY][flushX];
+            for(i = 0; i < run; i++) {
+                words[count++] = LCD_DATA | *pixel++;
+            }
+            flushX += run;
+            if(flushX > r->x1) {
+                flushX = r->x0;
+                flushY++;
+            }
+        }
+
+        if(flushY > r->y1) {
+            flushIndex++;
+            windowSent = 0;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * A staging buffer went out: refill it while the other one, started by the bus before this
+ * callback, is on the wire
+ */
+static void flush_next(spi_transaction *transaction) {
+    unsigned int count = 0;
+
+    if(transaction->status == SPIBUS_OPER_SUCCESS) {
+        count = flush_fill((uint16_t *)transaction->txBuffer);
+    }
+    if(count) {
+        transaction->length = count;
+        SPIBUS_Submit(transaction);
+    }
+    else if(--inFlight == 0) {
+        flushing = 0;
+    }
+}
+
+unsigned int LCDFB_Flush(void) {
+    unsigned int i, count;
+    uint32_t state;
+
+    if(flushing) {
+        return LCD_FB_OPER_BUSY;
+    }
+    if(!dirtyCount) {
+        return LCD_FB_OPER_SUCCESS;
+    }
+
+    // 'frame' is read as the staging buffers are refilled, drawing meanwhile may tear: the list
+    // is taken over so that what is changed from now on is sent again by the next flush
+    for(i = 0; i < dirtyCount; i++) {
+        flushRects[i] = dirty[i];
+    }
+    flushCount = dirtyCount;
+    dirtyCount = 0;
+    flushIndex = 0;
+    windowSent = 0;
+    inFlight = 0;
+    flushing = 1;
+
+    // Both buffers are staged before either is queued, so that a refill from the interrupt
+    // cannot overtake the second one
+    for(i = 0; i < 2; i++) {
+        count = flush_fill(staging[i]);
+        if(!count) {
+            break;
+        }
+        chunks[i].device = &lcdDevice;
+        chunks[i].txBuffer = staging[i];
+        chunks[i].rxBuffer = 0;
+        chunks[i].length = count;
+        chunks[i].flags = SPIBUS_KEEP_CS;
+        chunks[i].callback = flush_next;
+        chunks[i].ctx = 0;
+        inFlight++;
+    }
+
+    CRITICAL_ENTER(state);
+    for(i = 0; i < inFlight; i++) {
+        SPIBUS_Submit(&chunks[i]);
+    }
+    CRITICAL_EXIT(state);
+
+    return LCD_FB_OPER_SUCCESS;
+}
+
+unsigned int LCDFB_IsBusy(void) {
+    return flushing;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file     prof.c
+ * @brief    Cycle profiler: per site statistics of DWT CYCCNT measurements
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "prof.h"
+
+#if defined(__ICCARM__) || defined(__arm__)
+#include "common.h"
+#define LOG2(value)                         (31 - __CLZ(value))
+#else
+// Off target: single threaded, no interrupts
+#define CRITICAL_ENTER(state)               ((state) = 0)
+#define CRITICAL_EXIT(state)                ((void)(state))
+#define LOG2(value)                         (31 - __builtin_clz(value))
+#endif
+
+#define PROF_LINE_SIZE                      96
+
+static prof_site sites[PROF_MAX_SITES];
+static unsigned int siteCount;
+static uint32_t overhead;                   //!< Cycles of an empty PROF_BEGIN()/PROF_END()
+
+static void site_clear(prof_site *site) {
+    memset(site->hist, 0, sizeof(site->hist));
+    site->count = 0;
+    site->min = 0xFFFFFFFF;
+    site->max = 0;
+    site->total = 0;
+}
+
+void PROF_Init(void) {
+    uint32_t start;
+
+#if defined(__ICCARM__) || defined(__arm__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    start = PROF_CYCLES();
+    overhead = PROF_CYCLES() - start;
+}
+
+/**
+ * \return Index of the site named 'name', taken if new, PROF_NO_SITE if the table is full.
+ * Called with interrupts masked.
+ */
+static unsigned int site_find(const char *name) {
+    unsigned int index;
+
+    for(index = 0; index < siteCount; index++) {
+        if(sites[index].name == name || !strcmp(sites[index].name, name)) {
+            return index;
+        }
+    }
+    if(siteCount == PROF_MAX_SITES) {
+        return PROF_NO_SITE;
+    }
+    sites[siteCount].name = name;
+    site_clear(&sites[siteCount]);
+
+    return siteCount++;
+}
+
+void PROF_Record(unsigned char *site, const char *name, uint32_t cycles) {
+    prof_site *entry;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    if(*site == PROF_NO_SITE) {
+        *site = site_find(name);
+        if(*site == PROF_NO_SITE) {
+            CRITICAL_EXIT(state);
+            return;
+        }
+    }
+    entry = &sites[*site];
+
+    cycles = (cycles > overhead)? cycles - overhead : 0;
+    entry->count++;
+    entry->total += cycles;
+    if(cycles < entry->min) {
+        entry->min = cycles;
+    }
+    if(cycles > entry->max) {
+        entry->max = cycles;
+    }
+    // 0 and 1 cycle share the first bin
+    entry->hist[cycles? LOG2(cycles) : 0]++;
+    CRITICAL_EXIT(state);
+}
+
+unsigned int PROF_SiteCount(void) {
+    return siteCount;
+}
+
+const prof_site *PROF_GetSite(unsigned int index) {
+    if(index >= siteCount) {
+        return 0;
+    }
+    return &sites[index];
+}
+
+void PROF_Reset(void) {
+    unsigned int index;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    for(index = 0; index < siteCount; index++) {
+        site_clear(&sites[index]);
+    }
+    CRITICAL_EXIT(state);
+}
+
+void PROF_Dump(prof_output output, void *ctx) {
+    char line[PROF_LINE_SIZE];
+    prof_site site;
+    unsigned int index, bin, used;
+    uint32_t state;
+
+    for(index = 0; index < siteCount; index++) {
+        // A copy, the site may be updated from an interrupt while it is written out
+        CRITICAL_ENTER(state);
+        site = sites[index];
+        CRITICAL_EXIT(state);
+
+        if(!site.count) {
+            snprintf(line, sizeof(line), "%s: -", site.name);
+            output(line, ctx);
+            continue;
+        }
+        snprintf(line, sizeof(line), "%s: n=%lu min=%lu mean=%lu max=%lu", site.name,
+                 (unsigned long)site.count, (unsigned long)site.min,
+                 (unsigned long)(site.total / site.count), (unsigned long)site.max);
+        output(line, ctx);
+
+        used = 0;
+        for(bin = 0; bin < PROF_HIST_BINS; bin++) {
+            if(!site.hist[bin]) {
+                continue;
+            }
+            // Flushed when another bin might not fit
+            if(used > sizeof(line) - 24) {
+                output(line, ctx);
+                used = 0;
+            }
+            used += snprintf(line + used, sizeof(line) - used, "%s2^%u:%lu", used? " " : "  ",
+                             bin, (unsigned long)site.hist[bin]);
+        }
+        output(line, ctx);
+    }
+}
@@ -0,0 +1,202 @@
+/**
+ * @file     sched.c
+ * @brief    Cooperative run-to-completion scheduler
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "sched.h"
+#include "common.h"
+
+/// Ready tasks of one priority, FIFO
+typedef struct sched_queue_t {
+    sched_task *head;
+    sched_task *tail;
+} sched_queue;
+
+static sched_queue queues[SCHED_PRIORITIES];
+static volatile uint32_t readyMap;          //!< Bit n: queues[n] is not empty
+static volatile unsigned int readyCount;
+
+/**
+ * Called with interrupts masked
+ */
+static void sched_enqueue(sched_task *task) {
+    sched_queue *queue = &queues[task->priority];
+
+    task->next = 0;
+    if(queue->tail) {
+        queue->tail->next = task;
+    }
+    else {
+        queue->head = task;
+    }
+    queue->tail = task;
+    task->queued = 1;
+    readyMap |= 0x1 << task->priority;
+    readyCount++;
+}
+
+/**
+ * \return The highest priority ready task, taken off its queue, 0 if none.
+ * Called with interrupts masked.
+ */
+static sched_task *sched_dequeue(void) {
+    sched_queue *queue;
+    sched_task *task;
+    unsigned int priority;
+
+    if(!readyMap) {
+        return 0;
+    }
+    priority = 31 - __CLZ(readyMap);
+    queue = &queues[priority];
+    task = queue->head;
+    queue->head = task->next;
+    if(!queue->head) {
+        queue->tail = 0;
+        readyMap &= ~(0x1 << priority);
+    }
+    task->queued = 0;
+    readyCount--;
+
+    return task;
+}
+
+void SCHED_Init(void) {
+    unsigned int priority;
+
+    for(priority = 0; priority < SCHED_PRIORITIES; priority++) {
+        queues[priority].head = 0;
+        queues[priority].tail = 0;
+    }
+    readyMap = 0;
+    readyCount = 0;
+}
+
+static void sched_timer(swtimer *timer, void *ctx) {
+    sched_task *task = (sched_task *)ctx;
+
+    SCHED_Post(task, task->timerEvents);
+}
+
+unsigned int SCHED_AddTask(sched_task *task, sched_handler handler, void *ctx, unsigned int priority) {
+    if(priority >= SCHED_PRIORITIES) {
+        return SCHED_OPER_FAIL;
+    }
+    task->next = 0;
+    task->handler = handler;
+    task->ctx = ctx;
+    task->events = 0;
+    task->timerEvents = 0;
+    task->priority = priority;
+    task->queued = 0;
+    task->running = 0;
+    SWTIMER_Setup(&task->timer, sched_timer, task);
+
+    return SCHED_OPER_SUCCESS;
+}
+
+void SCHED_Post(sched_task *task, uint32_t events) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    task->events |= events;
+    // A running task is queued again when it returns
+    if(!task->queued && !task->running) {
+        sched_enqueue(task);
+    }
+    CRITICAL_EXIT(state);
+}
+
+void SCHED_PostIn(sched_task *task, uint32_t events, uint32_t delayUs) {
+    SWTIMER_Stop(&task->timer);
+    task->timerEvents = events;
+    SWTIMER_Start(&task->timer, delayUs, 0);
+}
+
+void SCHED_CancelPost(sched_task *task) {
+    SWTIMER_Stop(&task->timer);
+}
+
+unsigned int SCHED_RunOnce(void) {
+    sched_task *task;
+    uint32_t events;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    task = sched_dequeue();
+    if(!task) {
+        CRITICAL_EXIT(state);
+        return 0;
+    }
+    events = task->events;
+    task->events = 0;
+    task->running = 1;
+    CRITICAL_EXIT(state);
+
+    task->handler(task, events);
+
+    CRITICAL_ENTER(state);
+    task->running = 0;
+    if(task->events) {
+        sched_enqueue(task);
+    }
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+void SCHED_Run(void) {
+    uint32_t state;
+
+    for(;;) {
+        while(SCHED_RunOnce());
+
+        // Masked from the check to the WFI, so that a post from an interrupt cannot be slept through
+        CRITICAL_ENTER(state);
+        if(!readyMap) {
+            __WFI();
+        }
+        CRITICAL_EXIT(state);
+    }
+}
+
+void SCHED_Yield(void) {
+    unsigned int count = readyCount;
+
+    // Only those ready now: tasks that keep posting to themselves cannot hold the caller
+    while(count-- && SCHED_RunOnce());
+}
+
+void SCHED_Delay(unsigned int ms) {
+    uint64_t end = TIMER0_GetTicks64() + (uint64_t)ms * (TIMER_TICK_HZ / 1000);
+    uint32_t state;
+
+    for(;;) {
+        while(TIMER0_GetTicks64() < end && SCHED_RunOnce());
+
+        CRITICAL_ENTER(state);
+        if(TIMER0_GetTicks64() >= end) {
+            CRITICAL_EXIT(state);
+            break;
+        }
+        if(!readyMap) {
+            TIMER0_WaitForInterrupt(end);
+        }
+        CRITICAL_EXIT(state);
+    }
+    TIMER0_ClearMatch(TIMER_SLEEP_CHANNEL);
+}
+
+/* Hooks of the drivers written for a host scheduler (ethernet_drv.c). Weak: the kernel, when
+   linked in, provides its own. */
+
+__weak void DelayPort(unsigned int ms) {
+    SCHED_Delay(ms);
+}
+
+__weak void YieldPort(void) {
+    SCHED_Yield();
+}
@@ -0,0 +1,456 @@
+/**
+ * @file     sd_drv.c
+ * @brief    SD/MMC card over SPI
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "sd_drv.h"
+#include "crc.h"
+#include "timer_drv.h"
+
+/* Commands */
+#define CMD0                                0                   // GO_IDLE_STATE
+#define CMD1                                1                   // SEND_OP_COND (MMC)
+#define CMD8                                8                   // SEND_IF_COND
+#define CMD9                                9                   // SEND_CSD
+#define CMD12                               12                  // STOP_TRANSMISSION
+#define CMD16                               16                  // SET_BLOCKLEN
+#define CMD17                               17                  // READ_SINGLE_BLOCK
+#define CMD18                               18                  // READ_MULTIPLE_BLOCK
+#define CMD24                               24                  // WRITE_BLOCK
+#define CMD25                               25                  // WRITE_MULTIPLE_BLOCK
+#define CMD55                               55                  // APP_CMD
+#define CMD58                               58                  // READ_OCR
+#define CMD59                               59                  // CRC_ON_OFF
+#define ACMD_FLAG                           0x80                // Preceded by CMD55
+#define ACMD23                              (ACMD_FLAG | 23)    // SET_WR_BLK_ERASE_COUNT
+#define ACMD41                              (ACMD_FLAG | 41)    // SD_SEND_OP_COND
+
+/* Responses and tokens */
+#define R1_IDLE                             0x01
+#define R1_INVALID                          0x80
+#define TOKEN_START_BLOCK                   0xFE
+#define TOKEN_START_MULTI_WRITE             0xFC
+#define TOKEN_STOP_TRAN                     0xFD
+#define DATA_RESP_MASK                      0x1F
+#define DATA_RESP_ACCEPTED                  0x05
+#define DATA_RESP_CRC_ERROR                 0x0B
+
+#define CRC16_SD_INIT                       0x0000
+#define OCR_CCS                             0x40                // In the first OCR byte: block addressing
+#define IF_COND_ARG                         0x1AA               // 2.7-3.6 V, check pattern 0xAA
+#define ACMD41_HCS                          0x40000000UL
+
+static spi_bus_device sdDevice;
+static unsigned char cardType;
+static uint32_t blockCount;
+
+static unsigned int blockdev_read(const block_device *dev, uint32_t addr, void *dst, uint32_t size);
+static unsigned int blockdev_prog(const block_device *dev, uint32_t addr, const void *src, uint32_t size);
+static unsigned int blockdev_erase(const block_device *dev, uint32_t addr, uint32_t size);
+static unsigned int blockdev_sync(const block_device *dev);
+
+static block_device blockDevice = {
+    0, SD_BLOCK_SIZE, SD_BLOCK_SIZE, SD_BLOCK_SIZE, SD_BLOCK_SIZE,
+    blockdev_read, blockdev_prog, blockdev_erase, blockdev_sync,
+    0
+};
+
+static uint8_t sd_byte(uint8_t data) {
+    uint8_t in;
+    SPIBUS_Exchange(&sdDevice, &data, &in, 1);
+    return in;
+}
+
+/**
+ * Waits for the card to release MISO (it holds it low while busy)
+ */
+static unsigned int sd_wait_ready(unsigned int timeoutMs) {
+    unsigned int deadline = timer_deadline(MSToTicks(timeoutMs));
+
+    do {
+        if(sd_byte(0xFF) == 0xFF) {
+            return SD_OPER_SUCCESS;
+        }
+    } while(!timer_expired(deadline));
+    return SD_OPER_TIMEOUT;
+}
+
+static void sd_select(void) {
+    SPIBUS_Select(&sdDevice);
+}
+
+/**
+ * Releases the card. It only lets go of MISO on the clock edges following CS high.
+ */
+static void sd_deselect(void) {
+    sdDevice.csGpio->FIOSET = sdDevice.csMask;
+    sd_byte(0xFF);
+    SPIBUS_Deselect(&sdDevice);
+}
+
+/**
+ * Sends a command, a CMD55 first for application commands
+ * \return R1, R1_INVALID set on timeout
+ */
+static uint8_t sd_command(uint8_t cmd, uint32_t arg) {
+    uint8_t frame[6];
+    uint8_t r1;
+    unsigned int poll;
+
+    if(cmd & ACMD_FLAG) {
+        cmd &= ~ACMD_FLAG;
+        r1 = sd_command(CMD55, 0);
+        if(r1 > R1_IDLE) {
+            return r1;
+        }
+    }
+    // A multiple block read is stopped while the card is streaming, never busy
+    if(cmd != CMD12 && sd_wait_ready(SD_WRITE_TIMEOUT) != SD_OPER_SUCCESS) {
+        return R1_INVALID;
+    }
+
+    frame[0] = 0x40 | cmd;
+    frame[1] = (uint8_t)(arg >> 24);
+    frame[2] = (uint8_t)(arg >> 16);
+    frame[3] = (uint8_t)(arg >> 8);
+    frame[4] = (uint8_t)arg;
+    // Always valid: CMD0 and CMD8 need it even with the CRC off
+    frame[5] = (CRC7_Update(0, frame, 5) << 1) | 0x01;
+    SPIBUS_Exchange(&sdDevice, frame, 0, sizeof(frame));
+    if(cmd == CMD12) {
+        // Stuff byte
+        sd_byte(0xFF);
+    }
+
+    r1 = R1_INVALID;
+    for(poll = 0; poll < SD_CMD_TIMEOUT && (r1 & R1_INVALID); poll++) {
+        r1 = sd_byte(0xFF);
+    }
+
+    return r1;
+}
+
+/**
+ * Receives a data block: start token, data, CRC
+ */
+static unsigned int sd_read_data(void *dstAddr, unsigned int size) {
+    uint8_t token;
+    uint8_t crc[2];
+    unsigned int deadline = timer_deadline(MSToTicks(SD_READ_TIMEOUT));
+
+    do {
+        token = sd_byte(0xFF);
+    } while(token == 0xFF && !timer_expired(deadline));
+    if(token != TOKEN_START_BLOCK) {
+        // Error token or timeout
+        return (token == 0xFF)? SD_OPER_TIMEOUT : SD_OPER_FAIL;
+    }
+
+    if(SPIBUS_Exchange(&sdDevice, 0, dstAddr, size) != SPIBUS_OPER_SUCCESS) {
+        return SD_OPER_FAIL;
+    }
+    SPIBUS_Exchange(&sdDevice, 0, crc, sizeof(crc));
+#if SD_USE_CRC
+    if(CRC16_Update(CRC16_SD_INIT, dstAddr, size) != ((crc[0] << 8) | crc[1])) {
+        return SD_OPER_CRC_ERROR;
+    }
+#endif
+
+    return SD_OPER_SUCCESS;
+}
+
+/**
+ * Sends a data block and waits for the card to program it
+ */
+static unsigned int sd_write_data(uint8_t token, const void *srcAddr) {
+    uint8_t crc[2] = { 0xFF, 0xFF };
+    uint8_t response;
+
+#if SD_USE_CRC
+    uint16_t value = CRC16_Update(CRC16_SD_INIT, srcAddr, SD_BLOCK_SIZE);
+    crc[0] = (uint8_t)(value >> 8);
+    crc[1] = (uint8_t)value;
+#endif
+
+    sd_byte(token);
+    if(SPIBUS_Exchange(&sdDevice, srcAddr, 0, SD_BLOCK_SIZE) != SPIBUS_OPER_SUCCESS) {
+        return SD_OPER_FAIL;
+    }
+    SPIBUS_Exchange(&sdDevice, crc, 0, sizeof(crc));
+
+    response = sd_byte(0xFF) & DATA_RESP_MASK;
+    if(response != DATA_RESP_ACCEPTED) {
+        return (response == DATA_RESP_CRC_ERROR)? SD_OPER_CRC_ERROR : SD_OPER_FAIL;
+    }
+
+    return sd_wait_ready(SD_WRITE_TIMEOUT);
+}
+
+/**
+ * \return Capacity in SD_BLOCK_SIZE blocks from the CSD register
+ */
+static uint32_t sd_csd_blocks(const uint8_t *csd) {
+    uint32_t cSize;
+    unsigned int shift;
+
+    if((csd[0] >> 6) == 1) {
+        // CSD version 2.0: (C_SIZE + 1) * 512 KB
+        cSize = ((uint32_t)(csd[7] & 0x3F) << 16) | ((uint32_t)csd[8] << 8) | csd[9];
+        return (cSize + 1) << 10;
+    }
+
+    // CSD version 1.0: (C_SIZE + 1) * 2^(C_SIZE_MULT + 2) blocks of 2^READ_BL_LEN bytes
+    cSize = ((uint32_t)(csd[6] & 0x03) << 10) | ((uint32_t)csd[7] << 2) | (csd[8] >> 6);
+    shift = (((csd[9] & 0x03) << 1) | (csd[10] >> 7)) + 2 + (csd[5] & 0x0F);
+    return (cSize + 1) << (shift - 9);
+}
+
+static unsigned int sd_identify(void) {
+    uint8_t ocr[4];
+    uint8_t csd[16];
+    uint8_t r1;
+    uint8_t cmd;
+    unsigned int tries;
+    unsigned int deadline;
+    unsigned int type;
+
+    // 74+ clocks with CS high, then CMD0 with CS low selects SPI mode
+    sdDevice.csGpio->FIOSET = sdDevice.csMask;
+    for(tries = 0; tries < 10; tries++) {
+        sd_byte(0xFF);
+    }
+    sdDevice.csGpio->FIOCLR = sdDevice.csMask;
+
+    if(sd_command(CMD0, 0) != R1_IDLE) {
+        return SD_TYPE_NONE;
+    }
+#if SD_USE_CRC
+    if(sd_command(CMD59, 1) != R1_IDLE) {
+        return SD_TYPE_NONE;
+    }
+#endif
+
+    if(sd_command(CMD8, IF_COND_ARG) == R1_IDLE) {
+        // Version 2.00 or later
+        SPIBUS_Exchange(&sdDevice, 0, ocr, sizeof(ocr));
+        if(((ocr[2] << 8) | ocr[3]) != IF_COND_ARG) {
+            return SD_TYPE_NONE;
+        }
+        deadline = timer_deadline(MSToTicks(SD_INIT_TIMEOUT));
+        do {
+            r1 = sd_command(ACMD41, ACMD41_HCS);
+        } while(r1 != 0 && !timer_expired(deadline));
+        if(r1 != 0 || sd_command(CMD58, 0) != 0) {
+            return SD_TYPE_NONE;
+        }
+        SPIBUS_Exchange(&sdDevice, 0, ocr, sizeof(ocr));
+        type = (ocr[0] & OCR_CCS)? SD_TYPE_SDHC : SD_TYPE_SD2;
+    }
+    else {
+        // SD version 1.x or MMC, which rejects ACMD41
+        if(sd_command(ACMD41, 0) <= R1_IDLE) {
+            type = SD_TYPE_SD1;
+            cmd = ACMD41;
+        }
+        else {
+            type = SD_TYPE_MMC;
+            cmd = CMD1;
+        }
+        deadline = timer_deadline(MSToTicks(SD_INIT_TIMEOUT));
+        do {
+            r1 = sd_command(cmd, 0);
+        } while(r1 != 0 && !timer_expired(deadline));
+        if(r1 != 0) {
+            return SD_TYPE_NONE;
+        }
+    }
+
+    if(type != SD_TYPE_SDHC && sd_command(CMD16, SD_BLOCK_SIZE) != 0) {
+        return SD_TYPE_NONE;
+    }
+    if(sd_command(CMD9, 0) != 0 || sd_read_data(csd, sizeof(csd)) != SD_OPER_SUCCESS) {
+        return SD_TYPE_NONE;
+    }
+    blockCount = sd_csd_blocks(csd);
+
+    return type;
+}
+
+/**
+ * Powers the socket, if not already, and lets the supply settle
+ */
+static void sd_power_up(void) {
+    LPC_GPIO_TypeDef *pwr = GPIO_PORT(SD_PWR_PORT);
+    unsigned int deadline;
+
+    if((pwr->FIODIR & MMC_PWR_MASK) && !(pwr->FIOPIN & MMC_PWR_MASK)) {
+        return;
+    }
+
+    pwr->FIOCLR = MMC_PWR_MASK;
+    pwr->FIODIR |= MMC_PWR_MASK;
+    deadline = timer_deadline(MSToTicks(SD_POWER_UP_MS));
+    while(!timer_expired(deadline));
+}
+
+unsigned int SD_IsPresent(void) {
+    return !(GPIO_PORT(SD_CP_PORT)->FIOPIN & MMC_CP_MASK);
+}
+
+unsigned int SD_IsWriteProtected(void) {
+    return (GPIO_PORT(SD_WP_PORT)->FIOPIN & MMC_WP_MASK) != 0;
+}
+
+unsigned int SD_Init(void) {
+    unsigned int type;
+
+    cardType = SD_TYPE_NONE;
+    blockCount = 0;
+
+    // Nothing to wait for with the socket empty: identification would only time out
+    GPIO_PORT(SD_CP_PORT)->FIODIR &= ~MMC_CP_MASK;
+    GPIO_PORT(SD_WP_PORT)->FIODIR &= ~MMC_WP_MASK;
+    if(!SD_IsPresent()) {
+        return SD_OPER_NO_CARD;
+    }
+    sd_power_up();
+
+    sdDevice.port = SD_SSP_PORT;
+    sdDevice.csPort = SD_CS_PORT;
+    sdDevice.csPin = SD_CS_PIN;
+    sdDevice.mode = SSP_MODE_0;
+    sdDevice.bitData = 8;
+    sdDevice.frequency = SD_INIT_FREQUENCY;
+    if(SPIBUS_AddDevice(&sdDevice) != SPIBUS_OPER_SUCCESS) {
+        return SD_OPER_FAIL;
+    }
+
+    sd_select();
+    type = sd_identify();
+    sd_deselect();
+    if(type == SD_TYPE_NONE) {
+        return SD_OPER_FAIL;
+    }
+
+    // Data transfer mode
+    sdDevice.frequency = SD_FREQUENCY;
+    if(SPIBUS_AddDevice(&sdDevice) != SPIBUS_OPER_SUCCESS) {
+        return SD_OPER_FAIL;
+    }
+    cardType = type;
+    // Byte addressed block devices stop at 4 GB
+    blockDevice.size = (blockCount >= (0x1UL << 23))? 0xFFFFFE00UL : blockCount * SD_BLOCK_SIZE;
+
+    return SD_OPER_SUCCESS;
+}
+
+unsigned int SD_GetType(void) {
+    return cardType;
+}
+
+uint32_t SD_GetBlockCount(void) {
+    return blockCount;
+}
+
+unsigned int SD_ReadBlocks(uint32_t block, void *dstAddr, unsigned int count) {
+    uint32_t addr = (cardType == SD_TYPE_SDHC)? block : block * SD_BLOCK_SIZE;
+    unsigned int retVal = SD_OPER_SUCCESS;
+
+    if(cardType == SD_TYPE_NONE || count == 0 || block + count > blockCount || block + count < block) {
+        return SD_OPER_FAIL;
+    }
+
+    sd_select();
+    if(count == 1) {
+        retVal = (sd_command(CMD17, addr) == 0)? sd_read_data(dstAddr, SD_BLOCK_SIZE) : SD_OPER_FAIL;
+    }
+    else if(sd_command(CMD18, addr) != 0) {
+        retVal = SD_OPER_FAIL;
+    }
+    else {
+        // One command, then data blocks back to back
+        while(count-- > 0 && retVal == SD_OPER_SUCCESS) {
+            retVal = sd_read_data(dstAddr, SD_BLOCK_SIZE);
+            dstAddr = (uint8_t *)dstAddr + SD_BLOCK_SIZE;
+        }
+        sd_command(CMD12, 0);
+        if(sd_wait_ready(SD_WRITE_TIMEOUT) != SD_OPER_SUCCESS && retVal == SD_OPER_SUCCESS) {
+            retVal = SD_OPER_TIMEOUT;
+        }
+    }
+    sd_deselect();
+
+    return retVal;
+}
+
+unsigned int SD_WriteBlocks(uint32_t block, const void *srcAddr, unsigned int count) {
+    uint32_t addr = (cardType == SD_TYPE_SDHC)? block : block * SD_BLOCK_SIZE;
+    unsigned int retVal = SD_OPER_SUCCESS;
+
+    if(cardType == SD_TYPE_NONE || count == 0 || block + count > blockCount || block + count < block) {
+        return SD_OPER_FAIL;
+    }
+    if(SD_IsWriteProtected()) {
+        return SD_OPER_WRITE_PROTECTED;
+    }
+
+    sd_select();
+    if(count == 1) {
+        retVal = (sd_command(CMD24, addr) == 0)? sd_write_data(TOKEN_START_BLOCK, srcAddr) : SD_OPER_FAIL;
+    }
+    else {
+        // Pre-erasing lets the card program the blocks faster
+        if(cardType != SD_TYPE_MMC) {
+            sd_command(ACMD23, count);
+        }
+        if(sd_command(CMD25, addr) != 0) {
+            retVal = SD_OPER_FAIL;
+        }
+        else {
+            while(count-- > 0 && retVal == SD_OPER_SUCCESS) {
+                retVal = sd_write_data(TOKEN_START_MULTI_WRITE, srcAddr);
+                srcAddr = (const uint8_t *)srcAddr + SD_BLOCK_SIZE;
+            }
+            // Sent even after an error, to leave the receive data state
+            sd_byte(TOKEN_STOP_TRAN);
+            sd_byte(0xFF);
+            if(sd_wait_ready(SD_WRITE_TIMEOUT) != SD_OPER_SUCCESS && retVal == SD_OPER_SUCCESS) {
+                retVal = SD_OPER_TIMEOUT;
+            }
+        }
+    }
+    sd_deselect();
+
+    return retVal;
+}
+
+const block_device *SD_GetBlockDevice(void) {
+    return &blockDevice;
+}
+
+static unsigned int blockdev_read(const block_device *dev, uint32_t addr, void *dst, uint32_t size) {
+    if((addr | size) % SD_BLOCK_SIZE) {
+        return BLOCKDEV_OPER_FAIL;
+    }
+    return (SD_ReadBlocks(addr / SD_BLOCK_SIZE, dst, size / SD_BLOCK_SIZE) == SD_OPER_SUCCESS)? BLOCKDEV_OPER_SUCCESS : BLOCKDEV_OPER_FAIL;
+}
+
+static unsigned int blockdev_prog(const block_device *dev, uint32_t addr, const void *src, uint32_t size) {
+    if((addr | size) % SD_BLOCK_SIZE) {
+        return BLOCKDEV_OPER_FAIL;
+    }
+    return (SD_WriteBlocks(addr / SD_BLOCK_SIZE, src, size / SD_BLOCK_SIZE) == SD_OPER_SUCCESS)? BLOCKDEV_OPER_SUCCESS : BLOCKDEV_OPER_FAIL;
+}
+
+static unsigned int blockdev_erase(const block_device *dev, uint32_t addr, uint32_t size) {
+    // Cards erase as they program
+    return ((addr | size) % SD_BLOCK_SIZE || SD_IsWriteProtected())? BLOCKDEV_OPER_FAIL : BLOCKDEV_OPER_SUCCESS;
+}
+
+static unsigned int blockdev_sync(const block_device *dev) {
+    // Writes return once the card is no longer busy
+    return BLOCKDEV_OPER_SUCCESS;
+}
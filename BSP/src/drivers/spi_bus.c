@@ -0,0 +1,237 @@
+/**
+ * @file     spi_bus.c
+ * @brief    Shared SPI bus: per device settings and transaction queue on the SSP ports
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "spi_bus.h"
+#include "gpio_drv.h"
+#include "common.h"
+
+/// State of one SSP port used as a bus
+typedef struct spi_bus_t {
+    spi_transaction *head;
+    spi_transaction *tail;
+    spi_transaction *current;               //!< Running on DMA
+    spi_bus_device *configured;             //!< Device whose settings are loaded in the SSP
+    spi_bus_device *selected;               //!< Device whose chip select is asserted
+    volatile unsigned char owned;           //!< Taken by SPIBUS_Select()
+    unsigned int pclk;
+} spi_bus;
+
+static spi_bus buses[SSP_PORTS];
+
+static void bus_start(spi_bus *bus);
+
+static void bus_delay(unsigned int loops) {
+    while(loops--) {
+        __NOP();
+    }
+}
+
+void SPIBUS_Init(unsigned int port) {
+    spi_bus *bus = &buses[port];
+
+    // Device rates are solved for the PCLK InitClock() selected: CCLK, for rates up to CCLK / 2
+    bus->pclk = SSP_GetPclk(port);
+    SSP_Init(port, bus->pclk / 2, 8, SSP_MODE_0);
+    bus->head = 0;
+    bus->tail = 0;
+    bus->current = 0;
+    bus->configured = 0;
+    bus->selected = 0;
+    bus->owned = 0;
+}
+
+unsigned int SPIBUS_AddDevice(spi_bus_device *device) {
+    spi_bus *bus = &buses[device->port];
+    ssp_clock clock;
+    unsigned int loopsPerUs = SystemCoreClock / 1000000 / 4;    // ~4 cycles per bus_delay() loop
+
+    // DSS holds 4 to 16 bits, anything else would spill into the frame format
+    if(device->bitData < SSP_MIN_BITS || device->bitData > SSP_MAX_BITS ||
+       !SSP_SolveDivider(bus->pclk, device->frequency, &clock)) {
+        return SPIBUS_OPER_FAIL;
+    }
+    device->rate = clock.rate;
+    device->cpsr = clock.cpsr;
+    device->cr0 = SSP_CR0_DSS(device->bitData) | device->mode | SSP_CR0_SCR(clock.scr);
+    device->csSetupLoops = (device->csSetupNs * loopsPerUs + 999) / 1000;
+    device->csHoldLoops = (device->csHoldNs * loopsPerUs + 999) / 1000;
+
+    // A device may be added again with new settings
+    if(bus->configured == device) {
+        bus->configured = 0;
+    }
+
+    device->csGpio = GPIO_PORT(device->csPort);
+    device->csMask = 0x1 << device->csPin;
+    device->csGpio->FIOSET = device->csMask;
+    device->csGpio->FIODIR |= device->csMask;
+
+    return SPIBUS_OPER_SUCCESS;
+}
+
+/**
+ * Loads the settings of 'device' unless they are already in the SSP
+ */
+static void bus_configure(spi_bus *bus, spi_bus_device *device) {
+    if(bus->configured == device) {
+        return;
+    }
+    if(!bus->configured || bus->configured->cr0 != device->cr0 || bus->configured->cpsr != device->cpsr) {
+        SSP_SetFormat(device->port, device->cpsr, device->cr0);
+    }
+    bus->configured = device;
+}
+
+static void bus_cs_assert(spi_bus *bus, spi_bus_device *device) {
+    if(bus->selected == device) {
+        return;
+    }
+    if(bus->selected) {
+        bus_delay(bus->selected->csHoldLoops);
+        bus->selected->csGpio->FIOSET = bus->selected->csMask;
+    }
+    bus_configure(bus, device);
+    device->csGpio->FIOCLR = device->csMask;
+    bus_delay(device->csSetupLoops);
+    bus->selected = device;
+}
+
+static void bus_cs_release(spi_bus *bus) {
+    if(!bus->selected) {
+        return;
+    }
+    bus_delay(bus->selected->csHoldLoops);
+    bus->selected->csGpio->FIOSET = bus->selected->csMask;
+    bus->selected = 0;
+}
+
+/**
+ * End of a queued transaction, from the DMA interrupt
+ */
+static void bus_done(unsigned int port, unsigned int status, void *ctx) {
+    spi_bus *bus = (spi_bus *)ctx;
+    spi_transaction *transaction = bus->current;
+
+    bus->current = 0;
+    transaction->status = (status == GPDMA_STATUS_DONE)? SPIBUS_OPER_SUCCESS : SPIBUS_OPER_FAIL;
+    // The chip select stays asserted only if the next transaction can use it
+    if(transaction->status != SPIBUS_OPER_SUCCESS || !(transaction->flags & SPIBUS_KEEP_CS) ||
+       !bus->head || bus->head->device != transaction->device) {
+        bus_cs_release(bus);
+    }
+    // The next one goes on the wire first: the callback, e.g. refilling a buffer, overlaps it
+    bus_start(bus);
+
+    if(transaction->callback) {
+        transaction->callback(transaction);
+    }
+}
+
+/**
+ * Starts the next queued transaction if the bus is free. Called with interrupts masked or
+ * from the DMA interrupt.
+ */
+static void bus_start(spi_bus *bus) {
+    spi_transaction *transaction;
+
+    while(!bus->current && !bus->owned && bus->head) {
+        transaction = bus->head;
+        bus->head = transaction->next;
+        if(!bus->head) {
+            bus->tail = 0;
+        }
+
+        bus_cs_assert(bus, transaction->device);
+        bus->current = transaction;
+        if(SSP_TransferAsync(transaction->device->port, transaction->txBuffer, transaction->rxBuffer,
+                             transaction->length, bus_done, bus) != SSP_OPER_SUCCESS) {
+            bus->current = 0;
+            bus_cs_release(bus);
+            transaction->status = SPIBUS_OPER_FAIL;
+            if(transaction->callback) {
+                transaction->callback(transaction);
+            }
+        }
+    }
+}
+
+unsigned int SPIBUS_Submit(spi_transaction *transaction) {
+    spi_bus *bus = &buses[transaction->device->port];
+    uint32_t state;
+
+    transaction->status = SPIBUS_OPER_PENDING;
+    transaction->next = 0;
+
+    CRITICAL_ENTER(state);
+    if(bus->tail) {
+        bus->tail->next = transaction;
+    }
+    else {
+        bus->head = transaction;
+    }
+    bus->tail = transaction;
+    bus_start(bus);
+    CRITICAL_EXIT(state);
+
+    return SPIBUS_OPER_SUCCESS;
+}
+
+unsigned int SPIBUS_Wait(spi_transaction *transaction) {
+    while(transaction->status == SPIBUS_OPER_PENDING);
+
+    return transaction->status;
+}
+
+void SPIBUS_Select(spi_bus_device *device) {
+    spi_bus *bus = &buses[device->port];
+    uint32_t state;
+
+    for(;;) {
+        CRITICAL_ENTER(state);
+        if(!bus->owned && !bus->current && !bus->head) {
+            bus->owned = 1;
+            CRITICAL_EXIT(state);
+            break;
+        }
+        CRITICAL_EXIT(state);
+    }
+
+    bus_cs_assert(bus, device);
+}
+
+static void exchange_done(unsigned int port, unsigned int status, void *ctx) {
+    *(volatile unsigned int *)ctx = (status == GPDMA_STATUS_DONE)? SPIBUS_OPER_SUCCESS : SPIBUS_OPER_FAIL;
+}
+
+unsigned int SPIBUS_Exchange(spi_bus_device *device, const void *txBuffer, void *rxBuffer, unsigned int length) {
+    volatile unsigned int status = SPIBUS_OPER_PENDING;
+
+    if(length < SPIBUS_DMA_THRESHOLD) {
+        SSP_Transfer(device->port, txBuffer, rxBuffer, length);
+        return SPIBUS_OPER_SUCCESS;
+    }
+
+    if(SSP_TransferAsync(device->port, txBuffer, rxBuffer, length, exchange_done, (void *)&status) != SSP_OPER_SUCCESS) {
+        return SPIBUS_OPER_FAIL;
+    }
+    while(status == SPIBUS_OPER_PENDING);
+
+    return status;
+}
+
+void SPIBUS_Deselect(spi_bus_device *device) {
+    spi_bus *bus = &buses[device->port];
+    uint32_t state;
+
+    bus_cs_release(bus);
+
+    CRITICAL_ENTER(state);
+    bus->owned = 0;
+    bus_start(bus);
+    CRITICAL_EXIT(state);
+}
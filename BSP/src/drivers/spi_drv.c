@@ -9,7 +9,84 @@
 #include "spi_drv.h"
 #include "common.h"
 
-void SPI_Init(int frequency, int bitData) { // TODO: bitData to the SPI->SPCR
+/**
+ * Waits for the end of the current frame. Reading SPSR here and accessing SPDR next clears SPIF.
+ */
+static void spi_wait(void) {
+    spsr_register *status;
+    unsigned int spsr_val;
+    do {
+        spsr_val = SPI_GET_STATUS;
+        status = (spsr_register *)&spsr_val;
+    } while (!(status->SPIF));
+}
+
+static unsigned int spi_frame_bits(int bitData) {
+    if(bitData < SPI_MIN_BITS) {
+        return SPI_MIN_BITS;
+    }
+    if(bitData > SPI_MAX_BITS) {
+        return SPI_MAX_BITS;
+    }
+    return bitData;
+}
+
+unsigned int SPI_SolveDivider(unsigned int pclk, unsigned int frequency, spi_clock *clock) {
+    unsigned int divider;
+
+    if(frequency == 0) {
+        return 0;
+    }
+    // Smallest even divider not below pclk / frequency
+    divider = (pclk + frequency - 1) / frequency;
+    divider = (divider + 1) & ~0x1;
+    if(divider < SPI_MIN_DIVIDER) {
+        divider = SPI_MIN_DIVIDER;
+    }
+    if(divider > SPI_MAX_DIVIDER) {
+        return 0;
+    }
+
+    clock->divider = divider;
+    clock->rate = pclk / divider;
+
+    return clock->rate;
+}
+
+unsigned int SPI_SolveClock(unsigned int cclk, unsigned int frequency, spi_clock *clock) {
+    static const unsigned char modes[] = {
+        CLOCK_MODE_ONE_EIGHTH_OF_CCLOCK, CLOCK_MODE_ONE_FOURTH_OF_CCLOCK,
+        CLOCK_MODE_ONE_HALF_OF_CCLOCK, CLOCK_MODE_SAME_AS_CCLOCK
+    };
+    unsigned int i;
+    spi_clock candidate;
+
+    // Slowest settings, kept if nothing is slow enough
+    clock->pclkMode = CLOCK_MODE_ONE_EIGHTH_OF_CCLOCK;
+    clock->divider = SPI_MAX_DIVIDER;
+    clock->rate = cclk / CLOCK_MODE_DIVIDER(clock->pclkMode) / SPI_MAX_DIVIDER;
+    if(frequency == 0) {
+        return clock->rate;
+    }
+
+    // Slowest PCLK first: on a tie the lower peripheral clock is kept
+    for(i = 0; i < sizeof(modes); i++) {
+        if(!SPI_SolveDivider(cclk / CLOCK_MODE_DIVIDER(modes[i]), frequency, &candidate)) {
+            continue;
+        }
+        if(candidate.rate > clock->rate || clock->rate > frequency) {
+            *clock = candidate;
+            clock->pclkMode = modes[i];
+        }
+    }
+
+    return clock->rate;
+}
+
+unsigned int SPI_Init(int frequency, int bitData) {
+    spi_clock clock;
+    unsigned int pclk;
+
     SPI_POWER_ON;
     
     unsigned int mask;
@@ -20,14 +97,25 @@ void SPI_Init(int frequency, int bitData) { // TODO: bitData to the SPI->SPCR
                 ((PINSEL_SEL_ALT3) << (MOSI_SHIFT));
     SET_PIN_GROUP_FUNCTION(1, mask, functions);
     SET_PIN_FUNCTION(0, SCK_SHIFT, PINSEL_SEL_ALT3);
-    // same clock as the CPU
-    SET_PERIPHERAL_CLOCK_MODE(0, SPI_CLOCK_MODE_SHIFT, CLOCK_MODE_SAME_AS_CCLOCK);
-    // Conf clock divider - PCLOCK / frequency
-    SPI_SET_CLOCK(frequency);
+    // Conf clock - PCLK / SPCCR, PCLK as InitClock() selected it
+    clock.pclkMode = GET_PERIPHERAL_CLOCK_MODE(0, SPI_CLOCK_MODE_SHIFT);
+    pclk = PERIPHERAL_CLOCK_HZ(0, SPI_CLOCK_MODE_SHIFT);
+    if(frequency <= 0 || !SPI_SolveDivider(pclk, frequency, &clock)) {
+        // Slowest rate of this PCLK
+        clock.divider = SPI_MAX_DIVIDER;
+        clock.rate = pclk / SPI_MAX_DIVIDER;
+    }
+    SPI_SET_CLOCK(clock.divider);
     // Conf mode 
-    LPC_SPI->SPCR = SPCCR_MASK;
+    LPC_SPI->SPCR = SPCR_MODE_MASK | SPCR_BIT_ENABLE | SPCR_BITS(spi_frame_bits(bitData));
     // Reset flags
     SPI_GET_STATUS;
+
+    return clock.rate;
+}
+
+void SPI_SetFrameWidth(int bitData) {
+    LPC_SPI->SPCR = (LPC_SPI->SPCR & ~SPCR_BITS_MASK) | SPCR_BIT_ENABLE | SPCR_BITS(spi_frame_bits(bitData));
 }
 
 void SPI_BeginTransfer(int csBitId) {
@@ -42,15 +130,51 @@ void SPI_Transfer(unsigned short *txBuffer, unsigned short *rxBuffer, int lenght
     int i;
     for (i = 0; i < lenght; i++) {
         LPC_SPI->SPDR = *txBuffer++;
-
-        spsr_register *status;
-        unsigned int spsr_val;
-        do {
-            spsr_val = SPI_GET_STATUS;
-            status = (spsr_register *)&spsr_val;
-        } while (!(status->SPIF));
+        spi_wait();
         
         if(rxBuffer)
             *rxBuffer++ = LPC_SPI->SPDR;
     }
 }
+
+void SPI_TransferBytes(const unsigned char *txBuffer, unsigned char *rxBuffer, int lenght) {
+    int i;
+    for (i = 0; i < lenght; i++) {
+        LPC_SPI->SPDR = *txBuffer++;
+        spi_wait();
+
+        if(rxBuffer)
+            *rxBuffer++ = (unsigned char)LPC_SPI->SPDR;
+    }
+}
+
+void SPI_Write(const unsigned short *txBuffer, int lenght) {
+    int i;
+    // The next SPDR write clears SPIF, received frames are never read
+    for (i = 0; i < lenght; i++) {
+        LPC_SPI->SPDR = *txBuffer++;
+        spi_wait();
+    }
+    // Leave SPIF clear for the next transfer
+    if(lenght > 0)
+        (void)LPC_SPI->SPDR;
+}
+
+void SPI_WriteBytes(const unsigned char *txBuffer, int lenght) {
+    int i;
+    for (i = 0; i < lenght; i++) {
+        LPC_SPI->SPDR = *txBuffer++;
+        spi_wait();
+    }
+    if(lenght > 0)
+        (void)LPC_SPI->SPDR;
+}
+
+void SPI_ReadBytes(unsigned char *rxBuffer, int lenght, unsigned char fill) {
+    int i;
+    for (i = 0; i < lenght; i++) {
+        LPC_SPI->SPDR = fill;
+        spi_wait();
+        *rxBuffer++ = (unsigned char)LPC_SPI->SPDR;
+    }
+}
@@ -0,0 +1,271 @@
+/**
+ * @file     ssp_drv.c
+ * @brief    SSP driver
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "ssp_drv.h"
+#include "common.h"
+
+/// Per port state
+typedef struct ssp_port_t {
+    LPC_SSP_TypeDef *regs;
+    unsigned char rxChannel;
+    unsigned char txChannel;
+    unsigned char rxRequest;
+    unsigned char txRequest;
+    unsigned char wide;                     //!< Frames wider than 8 bits, stored as half words
+    volatile unsigned char busy;
+    ssp_callback callback;
+    void *ctx;
+    gpdma_lli rxLLI[SSP_DMA_LLI_MAX];
+    gpdma_lli txLLI[SSP_DMA_LLI_MAX];
+} ssp_port;
+
+static ssp_port ports[SSP_PORTS] = {
+    { LPC_SSP0, SSP0_DMA_RX_CHANNEL, SSP0_DMA_TX_CHANNEL, GPDMA_REQ_SSP0_RX, GPDMA_REQ_SSP0_TX, 0, 0, 0, 0, { { 0, 0, 0, 0 } }, { { 0, 0, 0, 0 } } },
+    { LPC_SSP1, SSP1_DMA_RX_CHANNEL, SSP1_DMA_TX_CHANNEL, GPDMA_REQ_SSP1_RX, GPDMA_REQ_SSP1_TX, 0, 0, 0, 0, { { 0, 0, 0, 0 } }, { { 0, 0, 0, 0 } } },
+};
+
+// A DMA source: in RAM, like any buffer of SSP_TransferAsync()
+static uint16_t txDummy = SSP_DUMMY_DATA;
+static uint16_t rxDummy;
+
+unsigned int SSP_SolveDivider(unsigned int pclk, unsigned int frequency, ssp_clock *clock) {
+    unsigned int target;
+    unsigned int cpsr;
+    unsigned int scr;
+    unsigned int best = 0;
+    unsigned int bestCpsr = 0;
+
+    if(frequency == 0) {
+        return 0;
+    }
+    target = (pclk + frequency - 1) / frequency;
+
+    // Smallest cpsr * (scr + 1) not below the target
+    for(cpsr = SSP_MIN_CPSR; cpsr <= SSP_MAX_CPSR; cpsr += 2) {
+        scr = (target + cpsr - 1) / cpsr;
+        if(scr == 0) {
+            scr = 1;
+        }
+        if(scr > SSP_MAX_SCR + 1) {
+            continue;
+        }
+        if(best == 0 || cpsr * scr < best) {
+            best = cpsr * scr;
+            bestCpsr = cpsr;
+            if(best == target) {
+                break;
+            }
+        }
+    }
+    if(best == 0) {
+        return 0;
+    }
+
+    clock->cpsr = bestCpsr;
+    clock->scr = best / bestCpsr - 1;
+    clock->rate = pclk / best;
+
+    return clock->rate;
+}
+
+unsigned int SSP_SolveClock(unsigned int cclk, unsigned int frequency, ssp_clock *clock) {
+    static const unsigned char modes[] = {
+        CLOCK_MODE_ONE_EIGHTH_OF_CCLOCK, CLOCK_MODE_ONE_FOURTH_OF_CCLOCK,
+        CLOCK_MODE_ONE_HALF_OF_CCLOCK, CLOCK_MODE_SAME_AS_CCLOCK
+    };
+    unsigned int i;
+    ssp_clock candidate;
+
+    // Slowest settings, kept if nothing is slow enough
+    clock->pclkMode = CLOCK_MODE_ONE_EIGHTH_OF_CCLOCK;
+    clock->cpsr = SSP_MAX_CPSR;
+    clock->scr = SSP_MAX_SCR;
+    clock->rate = cclk / CLOCK_MODE_DIVIDER(clock->pclkMode) / (SSP_MAX_CPSR * (SSP_MAX_SCR + 1));
+    if(frequency == 0) {
+        return clock->rate;
+    }
+
+    // Slowest PCLK first: on a tie the lower peripheral clock is kept
+    for(i = 0; i < sizeof(modes); i++) {
+        if(!SSP_SolveDivider(cclk / CLOCK_MODE_DIVIDER(modes[i]), frequency, &candidate)) {
+            continue;
+        }
+        if(candidate.rate > clock->rate || clock->rate > frequency) {
+            *clock = candidate;
+            clock->pclkMode = modes[i];
+        }
+    }
+
+    return clock->rate;
+}
+
+unsigned int SSP_GetPclk(unsigned int port) {
+    return (port == SSP_PORT0)? PERIPHERAL_CLOCK_HZ(1, SSP0_CLOCK_MODE_SHIFT) : PERIPHERAL_CLOCK_HZ(0, SSP1_CLOCK_MODE_SHIFT);
+}
+
+unsigned int SSP_Init(unsigned int port, unsigned int frequency, unsigned int bitData, unsigned int mode) {
+    ssp_port *ssp = &ports[port];
+    unsigned int pclk = SSP_GetPclk(port);
+    ssp_clock clock;
+
+    // PCLK stays as InitClock() selected it
+    if(!SSP_SolveDivider(pclk, frequency, &clock)) {
+        clock.cpsr = SSP_MAX_CPSR;
+        clock.scr = SSP_MAX_SCR;
+        clock.rate = pclk / (SSP_MAX_CPSR * (SSP_MAX_SCR + 1));
+    }
+
+    if(port == SSP_PORT0) {
+        SET_SSP0_POWER_ON;
+        SET_PIN_GROUP_FUNCTION(3, (0x3 << SSP0_SCK_SHIFT) | (0x3 << SSP0_MISO_SHIFT) | (0x3 << SSP0_MOSI_SHIFT),
+                               (PINSEL_SEL_ALT3 << SSP0_SCK_SHIFT) | (PINSEL_SEL_ALT3 << SSP0_MISO_SHIFT) | (PINSEL_SEL_ALT3 << SSP0_MOSI_SHIFT));
+    }
+    else {
+        SET_SSP1_POWER_ON;
+        SET_PIN_GROUP_FUNCTION(0, (0x3 << SSP1_SCK_SHIFT) | (0x3 << SSP1_MISO_SHIFT) | (0x3 << SSP1_MOSI_SHIFT),
+                               (PINSEL_SEL_ALT2 << SSP1_SCK_SHIFT) | (PINSEL_SEL_ALT2 << SSP1_MISO_SHIFT) | (PINSEL_SEL_ALT2 << SSP1_MOSI_SHIFT));
+    }
+
+    ssp->regs->CR1 = 0;
+    ssp->regs->CPSR = clock.cpsr;
+    ssp->regs->CR0 = SSP_CR0_DSS(bitData) | mode | SSP_CR0_SCR(clock.scr);
+    ssp->regs->DMACR = 0;
+    ssp->regs->CR1 = SSP_CR1_SSE;
+    ssp->wide = (bitData > 8);
+    ssp->busy = 0;
+
+    return clock.rate;
+}
+
+void SSP_Transfer(unsigned int port, const void *txBuffer, void *rxBuffer, unsigned int length) {
+    LPC_SSP_TypeDef *regs = ports[port].regs;
+    unsigned int wide = ports[port].wide;
+    unsigned int txCount = 0;
+    unsigned int rxCount = 0;
+    uint16_t data;
+
+    while(rxCount < length) {
+        // Keep at most a FIFO worth of frames in flight so the receive FIFO cannot overrun
+        while(txCount < length && txCount - rxCount < SSP_FIFO_DEPTH && (regs->SR & SSP_SR_TNF)) {
+            if(!txBuffer) {
+                data = SSP_DUMMY_DATA;
+            }
+            else {
+                data = wide? ((const uint16_t *)txBuffer)[txCount] : ((const uint8_t *)txBuffer)[txCount];
+            }
+            regs->DR = data;
+            txCount++;
+        }
+        while(regs->SR & SSP_SR_RNE) {
+            data = regs->DR;
+            if(rxBuffer) {
+                if(wide) {
+                    ((uint16_t *)rxBuffer)[rxCount] = data;
+                }
+                else {
+                    ((uint8_t *)rxBuffer)[rxCount] = (uint8_t)data;
+                }
+            }
+            rxCount++;
+        }
+    }
+}
+
+/**
+ * Receive channel completion: every frame has been shifted in, hence out
+ */
+static void ssp_dma_done(unsigned int channel, unsigned int status, void *ctx) {
+    ssp_port *ssp = (ssp_port *)ctx;
+
+    // Both channels may report an error: the transfer ends once
+    if(!ssp->busy) {
+        return;
+    }
+    if(status != GPDMA_STATUS_DONE) {
+        GPDMA_Stop(ssp->rxChannel);
+        GPDMA_Stop(ssp->txChannel);
+    }
+    ssp->regs->DMACR = 0;
+    ssp->busy = 0;
+    if(ssp->callback) {
+        ssp->callback(ssp - ports, status, ssp->ctx);
+    }
+}
+
+/**
+ * Transmit channel: only errors matter, completion is reported by the receive channel
+ */
+static void ssp_dma_tx_done(unsigned int channel, unsigned int status, void *ctx) {
+    if(status != GPDMA_STATUS_DONE) {
+        ssp_dma_done(channel, status, ctx);
+    }
+}
+
+unsigned int SSP_TransferAsync(unsigned int port, const void *txBuffer, void *rxBuffer, unsigned int length,
+                               ssp_callback callback, void *ctx) {
+    ssp_port *ssp = &ports[port];
+    uint32_t width = ssp->wide? GPDMA_WIDTH_HALFWORD : GPDMA_WIDTH_BYTE;
+    uint32_t control = GPDMA_CTRL_SBSIZE(GPDMA_BURST_4) | GPDMA_CTRL_DBSIZE(GPDMA_BURST_4) |
+                       GPDMA_CTRL_SWIDTH(width) | GPDMA_CTRL_DWIDTH(width);
+
+    if(ssp->busy || length == 0) {
+        return SSP_OPER_FAIL;
+    }
+
+    // Peripheral to memory, into a single dummy word when the data is not wanted
+    if(!GPDMA_BuildChain(ssp->rxLLI, SSP_DMA_LLI_MAX, (uint32_t)&ssp->regs->DR,
+                         rxBuffer? (uint32_t)rxBuffer : (uint32_t)&rxDummy, length,
+                         control | (rxBuffer? GPDMA_CTRL_DI : 0))) {
+        return SSP_OPER_FAIL;
+    }
+    // Memory to peripheral, repeating a dummy word when there is nothing to send
+    if(!GPDMA_BuildChain(ssp->txLLI, SSP_DMA_LLI_MAX, txBuffer? (uint32_t)txBuffer : (uint32_t)&txDummy,
+                         (uint32_t)&ssp->regs->DR, length,
+                         control | (txBuffer? GPDMA_CTRL_SI : 0))) {
+        return SSP_OPER_FAIL;
+    }
+
+    ssp->busy = 1;
+    ssp->callback = callback;
+    ssp->ctx = ctx;
+
+    // Leftovers of a previous transfer would shift the received data
+    while(ssp->regs->SR & SSP_SR_RNE) {
+        (void)ssp->regs->DR;
+    }
+    ssp->regs->ICR = SSP_ICR_RORIC;
+
+    if(GPDMA_Start(ssp->rxChannel, ssp->rxLLI, GPDMA_CH_P2M | GPDMA_CH_SRC_PERIPH(ssp->rxRequest), ssp_dma_done, ssp) != GPDMA_OPER_SUCCESS) {
+        ssp->busy = 0;
+        return SSP_OPER_FAIL;
+    }
+    if(GPDMA_Start(ssp->txChannel, ssp->txLLI, GPDMA_CH_M2P | GPDMA_CH_DST_PERIPH(ssp->txRequest), ssp_dma_tx_done, ssp) != GPDMA_OPER_SUCCESS) {
+        GPDMA_Stop(ssp->rxChannel);
+        ssp->busy = 0;
+        return SSP_OPER_FAIL;
+    }
+    ssp->regs->DMACR = SSP_DMACR_RXDMAE | SSP_DMACR_TXDMAE;
+
+    return SSP_OPER_SUCCESS;
+}
+
+void SSP_SetFormat(unsigned int port, uint32_t cpsr, uint32_t cr0) {
+    LPC_SSP_TypeDef *regs = ports[port].regs;
+
+    // Format changes are only allowed with the SSP disabled
+    while(regs->SR & SSP_SR_BSY);
+    regs->CR1 = 0;
+    regs->CPSR = cpsr;
+    regs->CR0 = cr0;
+    regs->CR1 = SSP_CR1_SSE;
+    ports[port].wide = ((cr0 & SSP_CR0_DSS_MASK) >= SSP_CR0_DSS(9));
+}
+
+unsigned int SSP_IsBusy(unsigned int port) {
+    return ports[port].busy;
+}
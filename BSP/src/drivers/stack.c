@@ -0,0 +1,146 @@
+/**
+ * @file     stack.c
+ * @brief    Main stack monitor: painting, high-water mark and MPU guard
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <stdio.h>
+
+#include "stack.h"
+#include "common.h"
+
+#define STACK_LINE_SIZE                     64
+#define STACK_MPU_REGION                    0
+
+/* SCB->CFSR, memory management fault status */
+#define MMFSR_IACCVIOL                      (0x1UL << 0)        // Instruction fetch
+#define MMFSR_DACCVIOL                      (0x1UL << 1)        // Data access, MMFAR valid
+#define MMFSR_MUNSTKERR                     (0x1UL << 3)        // Unstacking on exception return
+#define MMFSR_MSTKERR                       (0x1UL << 4)        // Stacking on exception entry
+#define MMFSR_MMARVALID                     (0x1UL << 7)
+#define MMFSR_MASK                          0xFFUL
+
+#define EXC_RETURN_PSP                      (0x1UL << 2)        // The frame is on the process stack
+#define FRAME_PC                            6                   // Word of the exception frame
+
+#if STACK_GUARD_ENABLED
+#define STACK_GUARD_BYTES                   STACK_GUARD_SIZE
+#else
+#define STACK_GUARD_BYTES                   0
+#endif
+
+#pragma section = "CSTACK"
+
+// Kept across the reset that follows a fault
+static __no_init stack_fault lastFault;
+// Taken over from lastFault at startup, so that a fault is reported after one reset only
+static stack_fault startupFault;
+
+static uint32_t *stack_bottom(void) {
+    return (uint32_t *)((uint8_t *)__section_begin("CSTACK") + STACK_GUARD_BYTES);
+}
+
+static uint32_t *stack_top(void) {
+    return (uint32_t *)__section_end("CSTACK");
+}
+
+void STACK_Paint(void) {
+    uint32_t *word = stack_bottom();
+    uint32_t *end = (uint32_t *)(__get_MSP() - STACK_PAINT_MARGIN);
+
+    while(word < end) {
+        *word++ = STACK_PAINT;
+    }
+}
+
+void STACK_Init(void) {
+    if(lastFault.magic == STACK_FAULT_MAGIC) {
+        startupFault = lastFault;
+        lastFault.magic = 0;
+    }
+    STACK_Paint();
+
+#if STACK_GUARD_ENABLED
+    // Region of 2^(SIZE + 1) bytes, no access, never executed; the default map elsewhere
+    MPU->CTRL = 0;
+    MPU->RNR = STACK_MPU_REGION;
+    MPU->RBAR = (uint32_t)__section_begin("CSTACK") & MPU_RBAR_ADDR_Msk;
+    MPU->RASR = MPU_RASR_XN_Msk | (0x0UL << MPU_RASR_AP_Pos)
+        | ((30UL - __CLZ(STACK_GUARD_SIZE)) << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk;
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+    __DSB();
+    __ISB();
+#endif
+}
+
+unsigned int STACK_GetHighWater(void) {
+    const uint32_t *word = stack_bottom();
+    const uint32_t *top = stack_top();
+
+    while(word < top && *word == STACK_PAINT) {
+        word++;
+    }
+    return (unsigned int)((top - word) * sizeof(uint32_t));
+}
+
+unsigned int STACK_GetSize(void) {
+    return (unsigned int)((stack_top() - stack_bottom()) * sizeof(uint32_t));
+}
+
+unsigned int STACK_GetFault(stack_fault *fault) {
+    if(startupFault.magic != STACK_FAULT_MAGIC) {
+        return STACK_OPER_FAIL;
+    }
+    *fault = startupFault;
+
+    return STACK_OPER_SUCCESS;
+}
+
+void STACK_Report(stack_output output, void *ctx) {
+    char line[STACK_LINE_SIZE];
+    unsigned int size = STACK_GetSize();
+    unsigned int used = STACK_GetHighWater();
+    stack_fault fault;
+
+    snprintf(line, sizeof(line), "CSTACK: size=%u used=%u free=%u guard=%u", size, used,
+             size - used, (unsigned int)STACK_GUARD_BYTES);
+    output(line, ctx);
+
+    if(STACK_GetFault(&fault) == STACK_OPER_SUCCESS) {
+        snprintf(line, sizeof(line), "fault: %s pc=0x%08lX sp=0x%08lX addr=0x%08lX mmfsr=0x%02lX",
+                 fault.overflow? "overflow" : "mpu", (unsigned long)fault.pc,
+                 (unsigned long)fault.sp, (unsigned long)fault.address, (unsigned long)fault.status);
+        output(line, ctx);
+    }
+}
+
+void STACK_Fault(uint32_t sp, uint32_t excReturn) {
+    uint32_t status = SCB->CFSR & MMFSR_MASK;
+    uint32_t guardTop = (uint32_t)stack_bottom();
+    const uint32_t *frame;
+
+    if(excReturn & EXC_RETURN_PSP) {
+        sp = __get_PSP();
+    }
+    frame = (const uint32_t *)sp;
+
+    lastFault.sp = sp;
+    // Nothing was stacked when stacking itself faulted
+    lastFault.pc = (status & MMFSR_MSTKERR)? 0 : frame[FRAME_PC];
+    lastFault.address = (status & MMFSR_MMARVALID)? SCB->MMFAR : 0;
+    lastFault.status = status;
+    lastFault.overflow = !(excReturn & EXC_RETURN_PSP) && ((status & MMFSR_MSTKERR) || sp < guardTop
+        || ((status & MMFSR_MMARVALID) && SCB->MMFAR < guardTop
+            && SCB->MMFAR >= (uint32_t)__section_begin("CSTACK")));
+    lastFault.magic = STACK_FAULT_MAGIC;
+    SCB->CFSR = status;
+
+    // Stops in the debugger when there is one
+    if(CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) {
+        __BKPT(0);
+    }
+    NVIC_SystemReset();
+}
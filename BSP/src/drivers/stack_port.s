@@ -0,0 +1,32 @@
+/**************************************************
+ *
+ * Memory management fault entry of the stack monitor (stack.c)
+ *
+ * The MPU guard at the bottom of CSTACK traps a stack overflow, often while
+ * the core stacks an exception frame: the stack pointer is then inside the
+ * guard and the first push of a C handler would fault again, escalating to
+ * a lockup. This entry moves the main stack pointer back to the top of
+ * CSTACK before calling STACK_Fault(), with the stack pointer the fault left
+ * and EXC_RETURN. It never returns, whatever was on the stack is given up.
+ *
+ **************************************************/
+
+        MODULE  ?stack_port
+
+        ;; Forward declaration of sections.
+        SECTION CSTACK:DATA:NOROOT(3)
+
+        EXTERN  STACK_Fault
+        PUBLIC  MemManage_Handler
+
+        SECTION .text:CODE:NOROOT(2)
+        THUMB
+
+MemManage_Handler
+        MRS     R0, MSP                     ; sp
+        MOV     R1, LR                      ; excReturn
+        LDR     R2, =sfe(CSTACK)
+        MSR     MSP, R2
+        B       STACK_Fault
+
+        END
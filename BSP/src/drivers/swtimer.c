@@ -0,0 +1,272 @@
+/**
+ * @file     swtimer.c
+ * @brief    Software timers in a hierarchical wheel, driven by one TIMER0 match
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include "swtimer.h"
+#include "common.h"
+
+#define SLOT_MASK                           (SWTIMER_SLOTS - 1)
+#define LEVEL_SHIFT(level)                  (SWTIMER_SLOT_BITS * (level))
+#define NO_EVENT                            (~(uint64_t)0)
+
+static swtimer *slots[SWTIMER_LEVELS][SWTIMER_SLOTS];
+static uint64_t occupied[SWTIMER_LEVELS];  //!< Bit n: slots[level][n] is not empty
+static uint64_t wheelTime;                 //!< Units, everything due up to here has been run
+
+static unsigned int ctz64(uint64_t value) {
+    uint32_t low = (uint32_t)value;
+
+    if(low) {
+        return __CLZ(__RBIT(low));
+    }
+    return 32 + __CLZ(__RBIT((uint32_t)(value >> 32)));
+}
+
+/**
+ * Files a timer in the level where its slot comes up within the next 64 of that level.
+ * Called with interrupts masked.
+ */
+static void wheel_insert(swtimer *timer) {
+    uint64_t expires = timer->expires;
+    unsigned int level;
+    uint64_t ahead = 0;
+
+    if(expires < wheelTime) {
+        expires = wheelTime;
+    }
+    for(level = 0; level < SWTIMER_LEVELS; level++) {
+        ahead = (expires >> LEVEL_SHIFT(level)) - (wheelTime >> LEVEL_SHIFT(level));
+        if(ahead < SWTIMER_SLOTS) {
+            break;
+        }
+    }
+    if(level == SWTIMER_LEVELS) {
+        // Beyond the span: parked in the farthest slot, filed again when it comes up
+        level = SWTIMER_LEVELS - 1;
+        ahead = SWTIMER_SLOTS - 1;
+    }
+
+    timer->level = level;
+    timer->slot = ((wheelTime >> LEVEL_SHIFT(level)) + ahead) & SLOT_MASK;
+    timer->prev = 0;
+    timer->next = slots[level][timer->slot];
+    if(timer->next) {
+        timer->next->prev = timer;
+    }
+    slots[level][timer->slot] = timer;
+    occupied[level] |= (uint64_t)0x1 << timer->slot;
+    timer->active = 1;
+}
+
+/**
+ * Called with interrupts masked
+ */
+static void wheel_remove(swtimer *timer) {
+    if(timer->prev) {
+        timer->prev->next = timer->next;
+    }
+    else {
+        slots[timer->level][timer->slot] = timer->next;
+        if(!timer->next) {
+            occupied[timer->level] &= ~((uint64_t)0x1 << timer->slot);
+        }
+    }
+    if(timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    timer->active = 0;
+}
+
+/**
+ * \return Units at which the first non-empty slot comes up, NO_EVENT if the wheel is empty.
+ * Called with interrupts masked.
+ */
+static uint64_t wheel_next_event(void) {
+    uint64_t next = NO_EVENT;
+    uint64_t when, map;
+    unsigned int level, current;
+
+    for(level = 0; level < SWTIMER_LEVELS; level++) {
+        map = occupied[level];
+        if(!map) {
+            continue;
+        }
+        // Slots are visited in turn from the current one
+        current = (wheelTime >> LEVEL_SHIFT(level)) & SLOT_MASK;
+        map = (map >> current) | (map << ((SWTIMER_SLOTS - current) & SLOT_MASK));
+        when = ((wheelTime >> LEVEL_SHIFT(level)) + ctz64(map)) << LEVEL_SHIFT(level);
+        if(when < next) {
+            next = when;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * Runs everything due up to 'now', units
+ */
+static void wheel_run(uint64_t now) {
+    uint64_t when;
+    unsigned int level, slot;
+    swtimer *timer, *moved;
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    for(;;) {
+        when = wheel_next_event();
+        if(when > now) {
+            break;
+        }
+        wheelTime = when;
+
+        // Upper slots coming up are moved down first, they may hold timers due right now
+        for(level = SWTIMER_LEVELS - 1; level > 0; level--) {
+            if(when & (((uint64_t)0x1 << LEVEL_SHIFT(level)) - 1)) {
+                continue;
+            }
+            slot = (when >> LEVEL_SHIFT(level)) & SLOT_MASK;
+            moved = slots[level][slot];
+            slots[level][slot] = 0;
+            occupied[level] &= ~((uint64_t)0x1 << slot);
+            while(moved) {
+                timer = moved;
+                moved = moved->next;
+                wheel_insert(timer);
+            }
+        }
+
+        // Level 0 holds what expires now. One at a time: callbacks may add to it.
+        slot = when & SLOT_MASK;
+        while((timer = slots[0][slot]) != 0) {
+            wheel_remove(timer);
+            if(timer->period) {
+                timer->expires += timer->period;
+                wheel_insert(timer);
+            }
+            CRITICAL_EXIT(state);
+            timer->callback(timer, timer->ctx);
+            CRITICAL_ENTER(state);
+        }
+    }
+    if(now > wheelTime) {
+        wheelTime = now;
+    }
+    CRITICAL_EXIT(state);
+}
+
+static uint64_t units_now(void) {
+    return TIMER0_GetTicks64() >> SWTIMER_UNIT_SHIFT;
+}
+
+static void swtimer_match(unsigned int channel);
+
+/**
+ * Arms the match for the next event, or soon enough to be caught if it is already due.
+ * Called with interrupts masked.
+ */
+static void swtimer_arm(void) {
+    uint64_t next = wheel_next_event();
+    uint64_t match, soon;
+
+    if(next == NO_EVENT) {
+        TIMER0_ClearMatch(SWTIMER_MATCH_CHANNEL);
+        return;
+    }
+    match = next << SWTIMER_UNIT_SHIFT;
+    soon = TIMER0_GetTicks64() + TIMER_MIN_LEAD;
+    if(match < soon) {
+        match = soon;
+    }
+    // Only the low 32 bits are matched: an event more than a counter wrap away just gets an
+    // early, empty, interrupt
+    TIMER0_SetMatch(SWTIMER_MATCH_CHANNEL, (uint32_t)match, swtimer_match);
+}
+
+static void swtimer_match(unsigned int channel) {
+    uint32_t state;
+
+    wheel_run(units_now());
+
+    CRITICAL_ENTER(state);
+    swtimer_arm();
+    CRITICAL_EXIT(state);
+}
+
+void SWTIMER_Init(void) {
+    unsigned int level, slot;
+
+    for(level = 0; level < SWTIMER_LEVELS; level++) {
+        for(slot = 0; slot < SWTIMER_SLOTS; slot++) {
+            slots[level][slot] = 0;
+        }
+        occupied[level] = 0;
+    }
+    wheelTime = units_now();
+    TIMER0_ClearMatch(SWTIMER_MATCH_CHANNEL);
+}
+
+void SWTIMER_Setup(swtimer *timer, swtimer_callback callback, void *ctx) {
+    timer->next = 0;
+    timer->prev = 0;
+    timer->callback = callback;
+    timer->ctx = ctx;
+    timer->period = 0;
+    timer->active = 0;
+}
+
+/**
+ * (Re)starts a timer on 'expires', units
+ */
+static void swtimer_start(swtimer *timer, uint64_t expires, uint32_t period) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    if(timer->active) {
+        wheel_remove(timer);
+    }
+    timer->expires = expires;
+    timer->period = period;
+    wheel_insert(timer);
+    swtimer_arm();
+    CRITICAL_EXIT(state);
+}
+
+/**
+ * \return Units covering 'ticks', rounded up
+ */
+static uint64_t ticks_to_units(uint64_t ticks) {
+    return (ticks + (0x1 << SWTIMER_UNIT_SHIFT) - 1) >> SWTIMER_UNIT_SHIFT;
+}
+
+void SWTIMER_Start(swtimer *timer, uint32_t delayUs, uint32_t periodUs) {
+    uint64_t expires = ticks_to_units(TIMER0_GetTicks64() + (uint64_t)delayUs * TIMER_TICKS_PER_US);
+    uint32_t period = (uint32_t)ticks_to_units((uint64_t)periodUs * TIMER_TICKS_PER_US);
+
+    if(periodUs && !period) {
+        period = 1;
+    }
+    swtimer_start(timer, expires, period);
+}
+
+void SWTIMER_StartAt(swtimer *timer, uint64_t ticks) {
+    swtimer_start(timer, ticks_to_units(ticks), 0);
+}
+
+void SWTIMER_Stop(swtimer *timer) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    if(timer->active) {
+        wheel_remove(timer);
+    }
+    CRITICAL_EXIT(state);
+}
+
+unsigned int SWTIMER_IsActive(const swtimer *timer) {
+    return timer->active;
+}
@@ -7,12 +7,20 @@
  **/
 
 #include "systick_drv.h"
+#include "irqtrace.h"
 
 static unsigned int counter;
+static systick_callback tickCallback;
 
 void SysTick_Handler(void)
 {
+    // The counter reloaded on the tick, it has counted down core cycles since
+    IRQTRACE_ENTER(SysTick->LOAD - SysTick->VAL);
     counter++;
+    if(tickCallback) {
+        tickCallback();
+    }
+    IRQTRACE_EXIT();
 }
 
 
@@ -34,3 +42,7 @@ unsigned int SYSTICK_Read(){
 void SYSTICK_Set(unsigned int value){
 
 }
+
+void SYSTICK_SetCallback(systick_callback callback){
+    tickCallback = callback;
+}
@@ -6,29 +6,88 @@
  *
  **/
 
-#include <limits.h>
-
 #include "timer_drv.h"
+#include "prof.h"
+#include "irqtrace.h"
 #include "common.h"
 
 
-unsigned int calc_prescaler_value(unsigned int frequency) {
-    unsigned int retVal = SystemCoreClock / frequency;
-    return retVal;
-}
+static volatile uint32_t timeHigh;          //!< TIMER0 wraps
+static timer_match_callback matchCallbacks[TIMER_MATCH_CHANNELS];
 
-void TIMER0_Init(unsigned int frequency) {
+void TIMER0_Init(void) {
     SET_TIMER0_POWER_ON;
     RESET_TIMER0;
     SET_TIMER0_DISABLED;
-    // same clck as the CPU
-    SET_PERIPHERAL_CLOCK_MODE(0, TIMER0_CLOCK_MODE_SHIFT, CLOCK_MODE_SAME_AS_CCLOCK);
-    //
+    // PCLK is left as it is: PCLKSEL changes may not take once PLL0 is connected
     SET_TIMER0_MODE(TIMER_MODE_TIMER);
-    LPC_TIM0->PR = calc_prescaler_value(frequency) - 1;
+    LPC_TIM0->PR = TIMER_PRESCALER - 1;
+    // MR3 on the last count before the wrap: interrupt, no reset
+    LPC_TIM0->MR3 = 0xFFFFFFFF;
+    LPC_TIM0->MCR = MCR_MRI(TIMER_WRAP_CHANNEL);
+    LPC_TIM0->IR = 0x3F;
+    timeHigh = 0;
     //
     UNRESET_TIMER0;
     SET_TIMER0_ENABLED;
+
+    NVIC_EnableIRQ(TIMER0_IRQn);
+}
+
+#if IRQTRACE_ENABLED
+/**
+ * \return Core cycles since the earliest of the pending matches, IRQTRACE_NO_LATENCY if none
+ */
+static uint32_t match_latency(uint32_t pending) {
+    volatile uint32_t *match = &LPC_TIM0->MR0;
+    uint32_t now = LPC_TIM0->TC;
+    uint32_t late, latest = 0;
+    unsigned int channel;
+
+    if(!(pending & 0xF)) {
+        return IRQTRACE_NO_LATENCY;
+    }
+    for(channel = 0; channel <= TIMER_WRAP_CHANNEL; channel++) {
+        late = now - match[channel];
+        if((pending & IR_MR(channel)) && late > latest) {
+            latest = late;
+        }
+    }
+
+    return latest * (SystemCoreClock / TIMER_TICK_HZ);
+}
+#endif
+
+void TMR0_IRQHandler(void) {
+    uint32_t pending = LPC_TIM0->IR;
+    uint32_t state;
+    unsigned int channel;
+    timer_match_callback callback;
+    PROF_BEGIN(tmr0Irq);
+
+    IRQTRACE_ENTER(match_latency(pending));
+
+    if(pending & IR_MR(TIMER_WRAP_CHANNEL)) {
+        // Counted and acknowledged together, TIMER0_GetTicks64() relies on either the count
+        // or the pending flag telling about the wrap
+        CRITICAL_ENTER(state);
+        timeHigh++;
+        LPC_TIM0->IR = IR_MR(TIMER_WRAP_CHANNEL);
+        CRITICAL_EXIT(state);
+    }
+
+    for(channel = 0; channel < TIMER_MATCH_CHANNELS; channel++) {
+        if(pending & IR_MR(channel)) {
+            LPC_TIM0->IR = IR_MR(channel);
+            callback = matchCallbacks[channel];
+            if(callback && (LPC_TIM0->MCR & MCR_MRI(channel))) {
+                TIMER0_ClearMatch(channel);
+                callback(channel);
+            }
+        }
+    }
+    PROF_END(tmr0Irq);
+    IRQTRACE_EXIT();
 }
 
 unsigned int TIMER0_GetValue(void) {
@@ -36,14 +95,112 @@ unsigned int TIMER0_GetValue(void) {
 }
 
 unsigned int TIMER0_Elapse(unsigned int lastRead) {
-    unsigned int currVal = TIMER0_GetValue();
-    unsigned int elapsed;
-    if(currVal < lastRead) {
-        currVal = currVal + (UINT_MAX - lastRead);
+    // Modulo 2^32: right across a wrap as well
+    return TIMER0_GetValue() - lastRead;
+}
+
+unsigned int timer_get_ticks(void) {
+    return LPC_TIM0->TC;
+}
+
+unsigned int timer_elapsed_ticks(unsigned int start) {
+    return LPC_TIM0->TC - start;
+}
+
+unsigned int timer_deadline(unsigned int ticks) {
+    return LPC_TIM0->TC + ticks;
+}
+
+int timer_expired(unsigned int deadline) {
+    // Signed difference: the deadline is at most 2^31 ticks away
+    return (int)(LPC_TIM0->TC - deadline) >= 0;
+}
+
+uint64_t TIMER0_GetTicks64(void) {
+    uint32_t high, low, pending;
+
+    do {
+        high = timeHigh;
+        low = LPC_TIM0->TC;
+        pending = LPC_TIM0->IR & IR_MR(TIMER_WRAP_CHANNEL);
+    } while(high != timeHigh);
+
+    // Wrapped but not counted yet: interrupts masked or the caller outranks TIMER0. The flag
+    // is set one tick before the wrap, hence the check on 'low'.
+    if(pending && low < 0x80000000UL) {
+        high++;
     }
-    else {
-        elapsed = currVal - lastRead;
+
+    return ((uint64_t)high << 32) | low;
+}
+
+uint64_t TIMER0_GetMicros(void) {
+    return TIMER0_GetTicks64() / TIMER_TICKS_PER_US;
+}
+
+void TIMER0_SetMatch(unsigned int channel, uint32_t ticks, timer_match_callback callback) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    matchCallbacks[channel] = callback;
+    (&LPC_TIM0->MR0)[channel] = ticks;
+    LPC_TIM0->IR = IR_MR(channel);
+    LPC_TIM0->MCR |= MCR_MRI(channel);
+    CRITICAL_EXIT(state);
+}
+
+void TIMER0_ClearMatch(unsigned int channel) {
+    uint32_t state;
+
+    CRITICAL_ENTER(state);
+    LPC_TIM0->MCR &= ~MCR_MRI(channel);
+    LPC_TIM0->IR = IR_MR(channel);
+    CRITICAL_EXIT(state);
+}
+
+static void sleep_wake(unsigned int channel) {
+    // Nothing to do: the interrupt alone ends the WFI
+}
+
+void TIMER0_WaitForInterrupt(uint64_t ticks) {
+    uint64_t now = TIMER0_GetTicks64();
+
+    if(now >= ticks) {
+        return;
+    }
+    TIMER0_SetMatch(TIMER_SLEEP_CHANNEL, (uint32_t)((ticks > now + TIMER_MIN_LEAD)? ticks : now + TIMER_MIN_LEAD), sleep_wake);
+    __WFI();
+}
+
+void TIMER0_SleepUntil(uint64_t ticks) {
+    uint32_t state;
+
+    for(;;) {
+        // Masked from the check to the WFI: a match in between stays pending and the WFI
+        // returns at once instead of sleeping past it
+        CRITICAL_ENTER(state);
+        if(TIMER0_GetTicks64() >= ticks) {
+            CRITICAL_EXIT(state);
+            break;
+        }
+        TIMER0_WaitForInterrupt(ticks);
+        CRITICAL_EXIT(state);
+    }
+    TIMER0_ClearMatch(TIMER_SLEEP_CHANNEL);
+}
+
+void TIMER0_SleepUs(uint32_t us) {
+    TIMER0_SleepUntil(TIMER0_GetTicks64() + (uint64_t)us * TIMER_TICKS_PER_US);
+}
+
+void TIMER0_DelayUs(uint32_t us) {
+    uint32_t start, cycles;
+
+    if(!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     }
-    
-    return elapsed + 1;
+    start = DWT->CYCCNT;
+    cycles = us * (SystemCoreClock / 1000000);
+    while(DWT->CYCCNT - start < cycles);
 }
@@ -0,0 +1,228 @@
+/**
+ * @file     eeprom_sim.c
+ * @brief    Host build: I2C EEPROM simulator standing in for i2c_drv.c
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "i2c_drv.h"
+#include "eeprom_sim.h"
+
+#define SIM_MAX_SIZE                        (256 * 1024UL)
+#define SIM_BUSY_POLLS                      3               // Address NAKs after a write cycle
+
+typedef enum sim_state_t {
+    SIM_IDLE,
+    SIM_ADDRESS,                            // Receiving the memory address
+    SIM_DATA,                               // Latching data bytes
+    SIM_READ
+} sim_state;
+
+jmp_buf eeprom_sim_cut;
+
+static unsigned char memory[SIM_MAX_SIZE];
+static unsigned long wear[SIM_MAX_SIZE];
+static unsigned int size = 8 * 1024, pageSize = 64, addrBytes = 2, blockMask;
+static eeprom_sim_stats stats;
+static long cutCountdown = -1;
+
+static sim_state state;
+static unsigned int pointer;                // Address counter of the device
+static unsigned int addrCount;
+static unsigned int pageBase;
+static unsigned char latch[FLASH_MAX_PAGE_SIZE];
+static unsigned char latched[FLASH_MAX_PAGE_SIZE];
+static unsigned int latchedCount;
+static unsigned int busy;
+
+
+void eeprom_sim_reset(const flash_device *dev) {
+    size = dev->size;
+    pageSize = dev->pageSize;
+    addrBytes = dev->addrBytes;
+    blockMask = (1U << dev->blockBits) - 1;
+    memset(memory, FLASH_DEFAULT_VALUE, sizeof(memory));
+    memset(wear, 0, sizeof(wear));
+    memset(&stats, 0, sizeof(stats));
+    cutCountdown = -1;
+    state = SIM_IDLE;
+    busy = 0;
+}
+
+void eeprom_sim_cut_after(long programs) {
+    cutCountdown = programs;
+}
+
+unsigned char *eeprom_sim_memory(void) {
+    return memory;
+}
+
+unsigned long eeprom_sim_wear(unsigned int addr) {
+    return wear[addr];
+}
+
+const eeprom_sim_stats *eeprom_sim_get_stats(void) {
+    return &stats;
+}
+
+/**
+ * Programs the latched bytes; on an armed power cut, a random part of them
+ */
+static void program_page(void) {
+    unsigned int cut = (cutCountdown >= 0 && cutCountdown-- == 0);
+    unsigned int i;
+
+    for(i = 0; i < pageSize; i++) {
+        if(!latched[i]) {
+            continue;
+        }
+        if(!cut) {
+            memory[pageBase + i] = latch[i];
+        }
+        else {
+            switch(rand() % 3) {
+            case 0:                         // Not reached yet
+                continue;
+            case 1:
+                memory[pageBase + i] = latch[i];
+                break;
+            default:                        // Cell left half programmed
+                memory[pageBase + i] = (unsigned char)rand();
+                break;
+            }
+        }
+        wear[pageBase + i]++;
+    }
+    stats.pagePrograms++;
+    busy = SIM_BUSY_POLLS;
+
+    if(cut) {
+        stats.cuts++;
+        state = SIM_IDLE;
+        busy = 0;
+        longjmp(eeprom_sim_cut, 1);
+    }
+}
+
+void I2C0_Init(void) {
+    // Power up: the bus is idle, a cut write cycle is over
+    state = SIM_IDLE;
+    busy = 0;
+}
+
+int I2C0_Start_Comunication(int isRestart, char address, int operation) {
+    stats.busBytes++;
+    if(busy) {
+        busy--;
+        return I2C_OPERATION_NOK;
+    }
+
+    pointer = (pointer & ((1U << (8 * addrBytes)) - 1)) | ((address & blockMask) << (8 * addrBytes));
+    if(operation == WRITE_OPERATION) {
+        state = SIM_ADDRESS;
+        addrCount = 0;
+        latchedCount = 0;
+        memset(latched, 0, sizeof(latched));
+        pointer &= ~((1U << (8 * addrBytes)) - 1);
+    }
+    else {
+        state = SIM_READ;
+        pointer %= size;
+    }
+
+    return I2C_OPERATION_OK;
+}
+
+int I2C0_Stop_Comunication(void) {
+    if(state == SIM_DATA && latchedCount) {
+        program_page();
+    }
+    state = SIM_IDLE;
+
+    return I2C_OPERATION_OK;
+}
+
+int I2C0_Send_Data(char *data, int len) {
+    unsigned int offset;
+    int i;
+
+    for(i = 0; i < len; i++) {
+        stats.busBytes++;
+        if(state == SIM_ADDRESS) {
+            pointer |= (unsigned char)data[i] << (8 * (addrBytes - 1 - addrCount));
+            if(++addrCount == addrBytes) {
+                pointer %= size;
+                pageBase = pointer - pointer % pageSize;
+                state = SIM_DATA;
+            }
+        }
+        else if(state == SIM_DATA) {
+            offset = pointer % pageSize;
+            latch[offset] = (unsigned char)data[i];
+            if(!latched[offset]) {
+                latched[offset] = 1;
+                latchedCount++;
+            }
+            // The address counter rolls over within the page
+            pointer = pageBase + (offset + 1) % pageSize;
+        }
+        else {
+            return I2C_OPERATION_NOK;
+        }
+    }
+
+    return I2C_OPERATION_OK;
+}
+
+int I2C0_Send_Fill(char value, int len) {
+    int i;
+
+    for(i = 0; i < len; i++) {
+        if(I2C0_Send_Data(&value, 1) != I2C_OPERATION_OK) {
+            return I2C_OPERATION_NOK;
+        }
+    }
+
+    return I2C_OPERATION_OK;
+}
+
+int I2C0_Receive_Data(char *buff, int len) {
+    int i;
+
+    if(state != SIM_READ) {
+        return I2C_OPERATION_NOK;
+    }
+    for(i = 0; i < len; i++) {
+        stats.busBytes++;
+        buff[i] = (char)memory[pointer];
+        pointer = (pointer + 1) % size;
+    }
+
+    return I2C_OPERATION_OK;
+}
+
+int I2C0_Receive_Byte(char *buff) {
+    return I2C0_Receive_Data(buff, 1);
+}
+
+int I2C0_Receive_Stream(int len, i2c_rx_handler handler, void *ctx) {
+    int i;
+
+    if(state != SIM_READ) {
+        return I2C_OPERATION_NOK;
+    }
+    for(i = 0; i < len; i++) {
+        stats.busBytes++;
+        if(handler((char)memory[pointer], ctx)) {
+            pointer = (pointer + 1) % size;
+            break;
+        }
+        pointer = (pointer + 1) % size;
+    }
+
+    return I2C_OPERATION_OK;
+}
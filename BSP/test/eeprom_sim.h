@@ -0,0 +1,65 @@
+/**
+ * @file     eeprom_sim.h
+ * @brief    Host build: I2C EEPROM simulator standing in for i2c_drv.c
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Implements the I2C0 API of i2c_drv.h on top of a simulated 24xx EEPROM, so that flash_drv.c and
+ * what sits on it run unchanged on the host. Data bytes are latched in a page buffer, wrapping
+ * within the page, and programmed at the stop condition; the device then NAKs its address for a
+ * few polls, as in its write cycle.
+ *
+ * A power cut can be armed on the n-th page program: each latched byte of that page is then left
+ * as it was, programmed, or garbled, at random, and the simulator longjmp()s to eeprom_sim_cut.
+ * The caller restarts the stack above as after a reset.
+ *
+ **/
+
+#ifndef __EEPROM_SIM_H__
+#define __EEPROM_SIM_H__
+
+#include <setjmp.h>
+
+#include "flash_drv.h"
+
+/// Target of the longjmp() on a power cut
+extern jmp_buf eeprom_sim_cut;
+
+/// Counters since eeprom_sim_reset()
+typedef struct eeprom_sim_stats_t {
+    unsigned long pagePrograms;             //!< Write cycles
+    unsigned long busBytes;                 //!< Address and data bytes on the bus, both ways
+    unsigned long cuts;                     //!< Power cuts taken
+} eeprom_sim_stats;
+
+/**
+ * Erases the whole device and clears the wear counters and statistics
+ *
+ * \param dev Geometry, as given to FLASH_InitDevice()
+ */
+void eeprom_sim_reset(const flash_device *dev);
+
+/**
+ * Arms a power cut
+ *
+ * \param programs Page programs let through before the cut one; -1 disarms
+ */
+void eeprom_sim_cut_after(long programs);
+
+/**
+ * \return The device memory, eeprom_sim_reset()'s geometry
+ */
+unsigned char *eeprom_sim_memory(void);
+
+/**
+ * \param addr Byte address
+ * \return Times the byte was programmed
+ */
+unsigned long eeprom_sim_wear(unsigned int addr);
+
+/**
+ * \return Counters since eeprom_sim_reset()
+ */
+const eeprom_sim_stats *eeprom_sim_get_stats(void);
+
+#endif /* __EEPROM_SIM_H__ */
@@ -0,0 +1,104 @@
+/**
+ * @file     core_cmFunc.h
+ * @brief    Host build: Cortex-M core register intrinsics in C
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Replaces the CMSIS header of the same name, see host.h. PRIMASK and IPSR are the simulated
+ * ones of host.c, the other core registers are plain variables.
+ *
+ **/
+
+#ifndef __CORE_CMFUNC_H
+#define __CORE_CMFUNC_H
+
+#include <stdint.h>
+#include "host.h"
+
+extern uint32_t host_control, host_psp, host_msp, host_basepri, host_faultmask;
+
+__STATIC_INLINE void __enable_irq(void) {
+    host_set_primask(0);
+}
+
+__STATIC_INLINE void __disable_irq(void) {
+    host_primask = 1;
+}
+
+__STATIC_INLINE uint32_t __get_PRIMASK(void) {
+    return host_primask;
+}
+
+__STATIC_INLINE void __set_PRIMASK(uint32_t priMask) {
+    host_set_primask(priMask & 1);
+}
+
+__STATIC_INLINE uint32_t __get_CONTROL(void) {
+    return host_control;
+}
+
+__STATIC_INLINE void __set_CONTROL(uint32_t control) {
+    host_control = control;
+}
+
+__STATIC_INLINE uint32_t __get_IPSR(void) {
+    return host_ipsr;
+}
+
+__STATIC_INLINE uint32_t __get_APSR(void) {
+    return 0;
+}
+
+__STATIC_INLINE uint32_t __get_xPSR(void) {
+    return host_ipsr;
+}
+
+__STATIC_INLINE uint32_t __get_PSP(void) {
+    return host_psp;
+}
+
+__STATIC_INLINE void __set_PSP(uint32_t topOfProcStack) {
+    host_psp = topOfProcStack;
+}
+
+__STATIC_INLINE uint32_t __get_MSP(void) {
+    return host_msp;
+}
+
+__STATIC_INLINE void __set_MSP(uint32_t topOfMainStack) {
+    host_msp = topOfMainStack;
+}
+
+__STATIC_INLINE void __enable_fault_irq(void) {
+    host_faultmask = 0;
+}
+
+__STATIC_INLINE void __disable_fault_irq(void) {
+    host_faultmask = 1;
+}
+
+__STATIC_INLINE uint32_t __get_BASEPRI(void) {
+    return host_basepri;
+}
+
+__STATIC_INLINE void __set_BASEPRI(uint32_t value) {
+    host_basepri = value & 0xFF;
+}
+
+__STATIC_INLINE uint32_t __get_FAULTMASK(void) {
+    return host_faultmask;
+}
+
+__STATIC_INLINE void __set_FAULTMASK(uint32_t faultMask) {
+    host_faultmask = faultMask & 1;
+}
+
+__STATIC_INLINE uint32_t __get_FPSCR(void) {
+    return 0;
+}
+
+__STATIC_INLINE void __set_FPSCR(uint32_t fpscr) {
+    (void)fpscr;
+}
+
+#endif /* __CORE_CMFUNC_H */
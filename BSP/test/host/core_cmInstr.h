@@ -0,0 +1,116 @@
+/**
+ * @file     core_cmInstr.h
+ * @brief    Host build: Cortex-M instruction intrinsics in C
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Replaces the CMSIS header of the same name, see host.h. The exclusive accesses always succeed:
+ * the host build runs one thread of execution at a time.
+ *
+ **/
+
+#ifndef __CORE_CMINSTR_H
+#define __CORE_CMINSTR_H
+
+#include <stdint.h>
+#include "host.h"
+
+__STATIC_INLINE void __NOP(void) {
+}
+
+__STATIC_INLINE void __WFI(void) {
+    if(host_wfi_hook) {
+        host_wfi_hook();
+    }
+}
+
+__STATIC_INLINE void __WFE(void) {
+    __WFI();
+}
+
+__STATIC_INLINE void __SEV(void) {
+}
+
+__STATIC_INLINE void __ISB(void) {
+    __sync_synchronize();
+}
+
+__STATIC_INLINE void __DSB(void) {
+    __sync_synchronize();
+}
+
+__STATIC_INLINE void __DMB(void) {
+    __sync_synchronize();
+}
+
+__STATIC_INLINE uint32_t __REV(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+__STATIC_INLINE uint32_t __REV16(uint32_t value) {
+    return ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8);
+}
+
+__STATIC_INLINE int32_t __REVSH(int32_t value) {
+    return (int16_t)__builtin_bswap16((uint16_t)value);
+}
+
+__STATIC_INLINE uint32_t __ROR(uint32_t op1, uint32_t op2) {
+    op2 &= 31;
+    return op2? (op1 >> op2) | (op1 << (32 - op2)) : op1;
+}
+
+#define __BKPT(value)                       __builtin_trap()
+
+__STATIC_INLINE uint32_t __RBIT(uint32_t value) {
+    uint32_t result = 0;
+    int i;
+
+    for(i = 0; i < 32; i++) {
+        result = (result << 1) | (value & 1);
+        value >>= 1;
+    }
+    return result;
+}
+
+__STATIC_INLINE uint8_t __LDREXB(volatile uint8_t *addr) {
+    return *addr;
+}
+
+__STATIC_INLINE uint16_t __LDREXH(volatile uint16_t *addr) {
+    return *addr;
+}
+
+__STATIC_INLINE uint32_t __LDREXW(volatile uint32_t *addr) {
+    return *addr;
+}
+
+__STATIC_INLINE uint32_t __STREXB(uint8_t value, volatile uint8_t *addr) {
+    *addr = value;
+    return 0;
+}
+
+__STATIC_INLINE uint32_t __STREXH(uint16_t value, volatile uint16_t *addr) {
+    *addr = value;
+    return 0;
+}
+
+__STATIC_INLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) {
+    *addr = value;
+    return 0;
+}
+
+__STATIC_INLINE void __CLREX(void) {
+}
+
+#define __SSAT(value, sat) \
+    ((int32_t)(value) > (int32_t)((1L << ((sat) - 1)) - 1)? (int32_t)((1L << ((sat) - 1)) - 1) : \
+     (int32_t)(value) < -(int32_t)(1L << ((sat) - 1))? -(int32_t)(1L << ((sat) - 1)) : (int32_t)(value))
+#define __USAT(value, sat) \
+    ((int32_t)(value) < 0? 0U : (uint32_t)(value) > ((1UL << (sat)) - 1)? ((1UL << (sat)) - 1) : (uint32_t)(value))
+
+__STATIC_INLINE uint8_t __CLZ(uint32_t value) {
+    return value? (uint8_t)__builtin_clz(value) : 32;
+}
+
+#endif /* __CORE_CMINSTR_H */
@@ -0,0 +1,72 @@
+/**
+ * @file     host.c
+ * @brief    Host build: simulated core state and peripheral memory
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "LPC17xx.h"
+
+/// Address windows of the LPC1768 the drivers access
+static const struct {
+    uintptr_t base;
+    size_t size;
+} windows[] = {
+    { 0x2007C000, 0x24000 },                // AHB SRAM (EMAC layout) up to the GPIO
+    { 0x40000000, 0x100000 },               // APB0, APB1, system control
+    { 0x50000000, 0x200000 },               // AHB peripherals: EMAC, GPDMA, USB
+    { 0xE0000000, 0x100000 },               // Private peripheral bus: DWT, SysTick, NVIC, SCB, MPU
+};
+
+volatile uint32_t host_primask;
+volatile uint32_t host_ipsr;
+uint32_t host_control, host_psp, host_msp, host_basepri, host_faultmask;
+void (*host_wfi_hook)(void);
+void (*host_unmask_hook)(void);
+
+uint32_t SystemCoreClock = 100000000;
+
+__attribute__((constructor))
+static void host_map_peripherals(void) {
+    unsigned int i;
+    void *window;
+
+    for(i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        window = mmap((void *)windows[i].base, windows[i].size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if(window != (void *)windows[i].base) {
+            fprintf(stderr, "host: cannot map the peripherals at 0x%08lX\n", (unsigned long)windows[i].base);
+            exit(2);
+        }
+    }
+}
+
+void host_reset_peripherals(void) {
+    unsigned int i;
+
+    for(i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        memset((void *)windows[i].base, 0, windows[i].size);
+    }
+}
+
+void host_set_primask(uint32_t mask) {
+    host_primask = mask;
+    if(!mask && host_unmask_hook) {
+        host_unmask_hook();
+    }
+}
+
+void host_run_handler(uint32_t exception, void (*handler)(void)) {
+    uint32_t ipsr = host_ipsr;
+
+    host_ipsr = exception;
+    handler();
+    host_ipsr = ipsr;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file     host.h
+ * @brief    Host build of the drivers: IAR keywords and the simulated core
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Included ahead of every source by the test Makefile. The drivers are built for the host with
+ * gcc, against the CMSIS headers of the project; core_cmInstr.h and core_cmFunc.h are taken from
+ * this directory instead, where the intrinsics act on the state below. The peripheral address
+ * windows of the LPC1768 are plain memory, mapped by host.c before main(): a register reads what
+ * was last written to it, unless a simulator (timer_sim.c...) plays the hardware.
+ *
+ **/
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <stdint.h>
+#include <sys/types.h>                      // Its ushort first: flash_drv.h defines one as a macro
+
+/* IAR keywords */
+#define __weak                              __attribute__((weak))
+#define __no_init
+#define __ramfunc
+#define __CORE__                            7                   // __ARM7M__, Cortex-M3, for arm_comm.h
+
+/// PRIMASK, 1 when interrupts are masked
+extern volatile uint32_t host_primask;
+/// IPSR, the exception number being handled, 0 in thread mode
+extern volatile uint32_t host_ipsr;
+
+/// Called by __WFI() and __WFE(): delivers the next interrupt. Nothing set, they return at once.
+extern void (*host_wfi_hook)(void);
+/// Called when PRIMASK is cleared: delivers what became pending while masked
+extern void (*host_unmask_hook)(void);
+
+/**
+ * Sets PRIMASK, calling host_unmask_hook when interrupts are enabled again
+ *
+ * \param mask New PRIMASK
+ */
+void host_set_primask(uint32_t mask);
+
+/**
+ * Runs a handler with IPSR set, as the core does. The caller checks PRIMASK.
+ *
+ * \param exception Exception number, 16 + IRQn
+ * \param handler Handler
+ */
+void host_run_handler(uint32_t exception, void (*handler)(void));
+
+/**
+ * Clears the peripheral windows, as after a reset
+ */
+void host_reset_peripherals(void);
+
+#endif /* __HOST_H__ */
@@ -0,0 +1,20 @@
+/**
+ * @file     intrinsics.h
+ * @brief    Host build: the IAR intrinsics board.h and arm_comm.h pull in
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __HOST_INTRINSICS_H__
+#define __HOST_INTRINSICS_H__
+
+#include "host.h"
+
+#define __enable_interrupt()                host_set_primask(0)
+#define __disable_interrupt()               (host_primask = 1)
+#define __get_interrupt_state()             (host_primask)
+#define __set_interrupt_state(state)        host_set_primask(state)
+#define __no_operation()                    ((void)0)
+
+#endif /* __HOST_INTRINSICS_H__ */
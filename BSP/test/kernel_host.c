@@ -0,0 +1,118 @@
+/**
+ * @file     kernel_host.c
+ * @brief    Host build: port of the preemptive kernel on ucontext, over the simulated TIMER0
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+#include "kernel_host.h"
+#include "timer_sim.h"
+
+/// At the top of a thread's stack, kernel_thread.sp points to it
+typedef struct host_context_t {
+    ucontext_t context;
+    kernel_entry entry;
+    void *arg;
+    void (*end)(void);
+} host_context;
+
+static ucontext_t mainContext;              //!< KERNEL_Start()'s caller
+static void (*timerUnmaskHook)(void);
+static void (*timerWfiHook)(void);
+static unsigned long switches;
+
+
+static host_context *context_of(kernel_thread *thread) {
+    return (host_context *)thread->sp;
+}
+
+/**
+ * First run of a thread: kernelCurrent is the thread
+ */
+static void thread_start(void) {
+    host_context *self = context_of(kernelCurrent);
+
+    self->entry(self->arg);
+    self->end();
+}
+
+/**
+ * PendSV: switches to kernelNext if pended, interrupts unmasked and in thread mode
+ */
+static void pendsv(void) {
+    kernel_thread *previous;
+
+    if(host_primask || host_ipsr || !(SCB->ICSR & SCB_ICSR_PENDSVSET_Msk)) {
+        return;
+    }
+    SCB->ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+    previous = kernelCurrent;
+    kernelCurrent = kernelNext;
+    if(previous == kernelCurrent) {
+        return;
+    }
+    switches++;
+    swapcontext(previous? &context_of(previous)->context : &mainContext, &context_of(kernelCurrent)->context);
+}
+
+static void unmask(void) {
+    // Pending interrupts first, then the switch they may have asked for
+    timerUnmaskHook();
+    pendsv();
+}
+
+static void wfi(void) {
+    if(timer_sim_next_match() == ~(uint64_t)0 && !host_primask) {
+        // Nothing can wake a thread any more
+        swapcontext(&context_of(kernelCurrent)->context, &mainContext);
+        return;
+    }
+    timerWfiHook();
+    pendsv();
+}
+
+uint32_t *KERNEL_PortInitStack(uint32_t *stack, unsigned int stackWords, kernel_entry entry, void *arg,
+                               void (*end)(void)) {
+    uintptr_t top = (uintptr_t)(stack + stackWords);
+    host_context *context = (host_context *)((top - sizeof(host_context)) & ~(uintptr_t)0xF);
+
+    if(stackWords < KERNEL_HOST_STACK_WORDS) {
+        fprintf(stderr, "kernel_host: stack of %u words, %u needed\n", stackWords, KERNEL_HOST_STACK_WORDS);
+        exit(1);
+    }
+    context->entry = entry;
+    context->arg = arg;
+    context->end = end;
+    getcontext(&context->context);
+    context->context.uc_stack.ss_sp = stack;
+    context->context.uc_stack.ss_size = (uint8_t *)context - (uint8_t *)stack;
+    context->context.uc_link = 0;
+    makecontext(&context->context, thread_start, 0);
+
+    return (uint32_t *)context;
+}
+
+void KERNEL_PortStart(void (*slice)(void)) {
+    timerUnmaskHook = host_unmask_hook;
+    timerWfiHook = host_wfi_hook;
+    host_unmask_hook = unmask;
+    host_wfi_hook = wfi;
+    switches = 0;
+
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    pendsv();
+
+    // Back here once blocked for good
+    host_unmask_hook = timerUnmaskHook;
+    host_wfi_hook = timerWfiHook;
+    kernelCurrent = 0;
+}
+
+unsigned long kernel_host_switches(void) {
+    return switches;
+}
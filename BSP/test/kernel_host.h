@@ -0,0 +1,30 @@
+/**
+ * @file     kernel_host.h
+ * @brief    Host build: port of the preemptive kernel on ucontext, over the simulated TIMER0
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Implements kernel_port.h for the host, so that kernel.c runs unchanged. Each thread is a
+ * ucontext on its own stack, the context sitting at the top of it. As on the chip, the switch
+ * pended in SCB->ICSR happens once interrupts are unmasked in thread mode, or when a handler
+ * returns to thread mode. The idle thread's WFI moves the clock of timer_sim.c on to the next
+ * match; with none armed, every thread is blocked for good and KERNEL_Start() returns.
+ *
+ * There are no time slices: threads of equal priority only alternate when they block or yield.
+ * Stacks take a context and what gcc needs, KERNEL_HOST_STACK_WORDS.
+ *
+ **/
+
+#ifndef __KERNEL_HOST_H__
+#define __KERNEL_HOST_H__
+
+#include "kernel_port.h"
+
+#define KERNEL_HOST_STACK_WORDS             4096
+
+/**
+ * \return Switches made since KERNEL_Start()
+ */
+unsigned long kernel_host_switches(void);
+
+#endif /* __KERNEL_HOST_H__ */
@@ -0,0 +1,246 @@
+/**
+ * @file     panel_sim.c
+ * @brief    Host build: PCF8833 panel simulator standing in for spi_bus.c, with a frame renderer
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "panel_sim.h"
+
+/* PCF8833 commands, as lcd_fb.c sends them */
+#define PCF_DATA                            0x100
+#define PCF_CASET                           0x2A
+#define PCF_PASET                           0x2B
+#define PCF_RAMWR                           0x2C
+#define PCF_RGBSET                          0x2D
+#define PCF_RGBSET_SIZE                     20          // 8 red, 8 green, 4 blue levels
+
+#define SIM_EXCEPTION                       (16 + DMA_IRQn)
+
+static uint8_t ram[PANEL_SIM_SIZE][PANEL_SIM_SIZE];
+static uint8_t rgbTable[PCF_RGBSET_SIZE];
+static panel_sim_stats stats;
+
+// Decoder
+static unsigned int command;
+static unsigned int parameter;
+static unsigned int x0, x1, y0, y1;
+static unsigned int x, y;
+
+// Queue
+static spi_transaction *head;
+static spi_transaction *tail;
+static spi_transaction *running;
+static unsigned int manual;
+static unsigned int pumping;
+
+
+static void panel_word(uint16_t word) {
+    unsigned int value = word & 0xFF;
+
+    stats.words++;
+    if(!(word & PCF_DATA)) {
+        command = word;
+        parameter = 0;
+        if(command == PCF_RAMWR) {
+            x = x0;
+            y = y0;
+        }
+        return;
+    }
+
+    switch(command) {
+    case PCF_CASET:
+        if(parameter == 0) {
+            x0 = value;
+        }
+        else {
+            x1 = value;
+        }
+        break;
+    case PCF_PASET:
+        if(parameter == 0) {
+            y0 = value;
+        }
+        else {
+            y1 = value;
+        }
+        break;
+    case PCF_RGBSET:
+        if(parameter < PCF_RGBSET_SIZE) {
+            rgbTable[parameter] = value & 0xF;
+        }
+        break;
+    case PCF_RAMWR:
+        if(x < PANEL_SIM_SIZE && y < PANEL_SIM_SIZE) {
+            ram[y][x] = value;
+            stats.ramWrites++;
+        }
+        // The address counter wraps within the window
+        if(++x > x1) {
+            x = x0;
+            if(++y > y1) {
+                y = y0;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+    parameter++;
+}
+
+static void panel_words(const void *txBuffer, unsigned int length) {
+    const uint16_t *words = txBuffer;
+    unsigned int i;
+
+    stats.transactions++;
+    for(i = 0; i < length; i++) {
+        panel_word(words? words[i] : SSP_DUMMY_DATA);
+    }
+}
+
+static void run_callback(void) {
+    running->callback(running);
+}
+
+unsigned int panel_sim_step(void) {
+    spi_transaction *transaction = head;
+
+    if(!transaction) {
+        return 0;
+    }
+    head = transaction->next;
+    if(!head) {
+        tail = 0;
+    }
+
+    panel_words(transaction->txBuffer, transaction->length);
+    transaction->status = SPIBUS_OPER_SUCCESS;
+    if(transaction->callback) {
+        running = transaction;
+        host_run_handler(SIM_EXCEPTION, run_callback);
+    }
+
+    return 1;
+}
+
+/**
+ * Runs the queue as the DMA interrupt would, unless masked or in manual mode
+ */
+static void pump(void) {
+    if(manual || pumping || host_primask) {
+        return;
+    }
+    pumping = 1;
+    while(panel_sim_step());
+    pumping = 0;
+}
+
+void panel_sim_reset(void) {
+    memset(ram, 0, sizeof(ram));
+    memset(rgbTable, 0, sizeof(rgbTable));
+    memset(&stats, 0, sizeof(stats));
+    command = 0;
+    x0 = y0 = x = y = 0;
+    x1 = y1 = PANEL_SIM_SIZE - 1;
+    head = tail = 0;
+    manual = 0;
+    pumping = 0;
+    host_unmask_hook = pump;
+}
+
+void panel_sim_set_manual(unsigned int value) {
+    manual = value;
+    pump();
+}
+
+const uint8_t *panel_sim_ram(void) {
+    return &ram[0][0];
+}
+
+const panel_sim_stats *panel_sim_get_stats(void) {
+    return &stats;
+}
+
+unsigned long panel_sim_bus_us(unsigned int rate) {
+    return (unsigned long)((unsigned long long)stats.words * 9 * 1000000 / rate);
+}
+
+int panel_sim_write_ppm(const char *path, unsigned int scale) {
+    FILE *file = fopen(path, "wb");
+    unsigned int row, column;
+    uint8_t pixel;
+
+    if(!file) {
+        return -1;
+    }
+    fprintf(file, "P6\n%u %u\n255\n", PANEL_SIM_SIZE * scale, PANEL_SIM_SIZE * scale);
+    for(row = 0; row < PANEL_SIM_SIZE * scale; row++) {
+        for(column = 0; column < PANEL_SIM_SIZE * scale; column++) {
+            pixel = ram[row / scale][column / scale];
+            // 4-bit levels of the color table, RGB332 indices
+            fputc(rgbTable[pixel >> 5] * 17, file);
+            fputc(rgbTable[8 + ((pixel >> 2) & 0x7)] * 17, file);
+            fputc(rgbTable[16 + (pixel & 0x3)] * 17, file);
+        }
+    }
+
+    return fclose(file)? -1 : 0;
+}
+
+/* SPIBUS API */
+
+void SPIBUS_Init(unsigned int port) {
+}
+
+unsigned int SPIBUS_AddDevice(spi_bus_device *device) {
+    if(device->bitData < SSP_MIN_BITS || device->bitData > SSP_MAX_BITS || !device->frequency) {
+        return SPIBUS_OPER_FAIL;
+    }
+    device->rate = device->frequency;
+
+    return SPIBUS_OPER_SUCCESS;
+}
+
+unsigned int SPIBUS_Submit(spi_transaction *transaction) {
+    transaction->status = SPIBUS_OPER_PENDING;
+    transaction->next = 0;
+    if(tail) {
+        tail->next = transaction;
+    }
+    else {
+        head = transaction;
+    }
+    tail = transaction;
+    pump();
+
+    return SPIBUS_OPER_SUCCESS;
+}
+
+unsigned int SPIBUS_Wait(spi_transaction *transaction) {
+    while(transaction->status == SPIBUS_OPER_PENDING && panel_sim_step());
+
+    return transaction->status;
+}
+
+void SPIBUS_Select(spi_bus_device *device) {
+    // Takes the bus once the queue has drained
+    while(panel_sim_step());
+}
+
+unsigned int SPIBUS_Exchange(spi_bus_device *device, const void *txBuffer, void *rxBuffer, unsigned int length) {
+    panel_words(txBuffer, length);
+    if(rxBuffer) {
+        memset(rxBuffer, 0, length * sizeof(uint16_t));
+    }
+
+    return SPIBUS_OPER_SUCCESS;
+}
+
+void SPIBUS_Deselect(spi_bus_device *device) {
+}
@@ -0,0 +1,77 @@
+/**
+ * @file     panel_sim.h
+ * @brief    Host build: PCF8833 panel simulator standing in for spi_bus.c, with a frame renderer
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Implements the SPIBUS API of spi_bus.h for a single PCF8833 panel, so that lcd_fb.c runs
+ * unchanged on the host. The 9-bit words are decoded as the panel does (CASET, PASET, RAMWR,
+ * RGBSET) into a panel RAM, which can be written out as a PPM image.
+ *
+ * Queued transactions go out in order, as the DMA interrupt would run them: at once when
+ * interrupts are enabled, else when PRIMASK is cleared. In manual mode they wait for
+ * panel_sim_step(), so that a test can draw in the middle of a flush.
+ *
+ **/
+
+#ifndef __PANEL_SIM_H__
+#define __PANEL_SIM_H__
+
+#include <stdint.h>
+
+#include "lcd_fb.h"
+
+#define PANEL_SIM_SIZE                      132
+
+/// Counters since panel_sim_reset()
+typedef struct panel_sim_stats_t {
+    unsigned long words;                    //!< 9-bit frames on the bus
+    unsigned long transactions;             //!< Queued transactions and SPIBUS_Exchange() calls
+    unsigned long ramWrites;                //!< Pixels written to the panel RAM
+} panel_sim_stats;
+
+/**
+ * Clears the panel RAM and the counters and goes back to automatic mode
+ */
+void panel_sim_reset(void);
+
+/**
+ * \param manual 1: queued transactions wait for panel_sim_step(); 0: they run as soon as they can
+ */
+void panel_sim_set_manual(unsigned int manual);
+
+/**
+ * Runs the oldest queued transaction and its callback
+ *
+ * \return 0 if the queue was empty
+ */
+unsigned int panel_sim_step(void);
+
+/**
+ * \return The panel RAM, PANEL_SIM_SIZE rows of PANEL_SIM_SIZE RGB332 pixels
+ */
+const uint8_t *panel_sim_ram(void);
+
+/**
+ * \return Counters since panel_sim_reset()
+ */
+const panel_sim_stats *panel_sim_get_stats(void);
+
+/**
+ * Bus time of the words counted since panel_sim_reset()
+ *
+ * \param rate Bit rate, Hz
+ * \return Microseconds
+ */
+unsigned long panel_sim_bus_us(unsigned int rate);
+
+/**
+ * Writes what the panel shows as a binary PPM, through the color table it was sent
+ *
+ * \param path File
+ * \param scale Pixels per panel pixel, each way
+ * \return 0 on success
+ */
+int panel_sim_write_ppm(const char *path, unsigned int scale);
+
+#endif /* __PANEL_SIM_H__ */
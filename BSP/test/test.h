@@ -0,0 +1,33 @@
+/**
+ * @file     test.h
+ * @brief    Host tests: checks
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * A test is a program: it returns 0 when every check held and stops at the first one that did
+ * not, with its location, exit code 1.
+ *
+ **/
+
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_CHECK(cond) do { \
+        if(!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1); \
+        } \
+    } while(0)
+
+#define TEST_EQUAL(actual, expected) do { \
+        long long actual_ = (long long)(actual), expected_ = (long long)(expected); \
+        if(actual_ != expected_) { \
+            fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, actual_, expected_); \
+            exit(1); \
+        } \
+    } while(0)
+
+#endif /* __TEST_H__ */
@@ -0,0 +1,46 @@
+/**
+ * @file     test_irq.c
+ * @brief    Host test of the interrupt configuration: priorities and enables after IRQ_Init()
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * irq_drv.c as built for the target, without the RAM vectors. The NVIC and the SCB are plain
+ * memory, left by the test at the reset priority 0.
+ *
+ **/
+
+#include "irq_drv.h"
+#include "test.h"
+
+#define IRQS                                (IRQ_VECTORS - 16)
+
+static unsigned int preempt(IRQn_Type irq) {
+    return NVIC_GetPriority(irq) >> IRQ_SUB_BITS;
+}
+
+int main(void) {
+    int irq;
+
+    IRQ_Init();
+    TEST_EQUAL(NVIC_GetPriorityGrouping(), IRQ_PRIORITY_GROUP);
+
+    // The table
+    TEST_EQUAL(NVIC_GetPriority(MemoryManagement_IRQn), IRQ_PRIORITY(0, 0));
+    TEST_EQUAL(NVIC_GetPriority(TIMER0_IRQn), IRQ_PRIORITY(1, 0));
+    TEST_EQUAL(NVIC_GetPriority(SSP1_IRQn), IRQ_PRIORITY(3, 1));
+    TEST_EQUAL(NVIC_GetPriority(PendSV_IRQn), IRQ_PRIORITY(IRQ_LOWEST_PREEMPT, IRQ_LOWEST_SUB));
+
+    // Everything else below the memory management fault and the table, above the kernel
+    for(irq = 0; irq < IRQS; irq++) {
+        TEST_CHECK(preempt((IRQn_Type)irq) > preempt(MemoryManagement_IRQn));
+        TEST_CHECK(preempt((IRQn_Type)irq) < preempt(PendSV_IRQn));
+    }
+    TEST_EQUAL(NVIC_GetPriority(UART0_IRQn), IRQ_PRIORITY(IRQ_DEFAULT_PREEMPT, 0));
+    TEST_EQUAL(NVIC_GetPriority(CANActivity_IRQn), IRQ_PRIORITY(IRQ_DEFAULT_PREEMPT, 0));
+
+    // Nothing in the table is enabled at startup
+    TEST_EQUAL(NVIC->ISER[0], 0);
+    TEST_EQUAL(NVIC->ISER[1], 0);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file     test_irqtrace.c
+ * @brief    Host test of the interrupt tracer: latencies as exported and as decoded
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * irqtrace.c as built for the target, with IRQTRACE_ENABLED 1. The export is written to
+ * build/irqtrace.bin and run through tools/irqtrace_decode.py.
+ *
+ **/
+
+#include <string.h>
+
+#include "irqtrace.h"
+#include "test.h"
+
+#define TEST_EXPORT                         "build/irqtrace.bin"
+#define TEST_DECODER                        "python3 ../../tools/irqtrace_decode.py " TEST_EXPORT
+#define HEADER_SIZE                         20
+#define EVENT_SIZE                          8
+
+/// Latency passed to IRQTRACE_Enter(), and the one exported
+static const uint32_t latencies[][2] = {
+    {50, 50},
+    {IRQTRACE_MAX_LATENCY, IRQTRACE_MAX_LATENCY},
+    {IRQTRACE_NO_LATENCY + 1, IRQTRACE_MAX_LATENCY},
+    {0x123456, IRQTRACE_MAX_LATENCY},
+    {IRQTRACE_NO_LATENCY, IRQTRACE_NO_LATENCY},
+};
+
+#define COUNT(array)                        (sizeof(array) / sizeof((array)[0]))
+
+static unsigned int current;
+static uint8_t exported[HEADER_SIZE + 2 * COUNT(latencies) * EVENT_SIZE];
+static unsigned int exportedLength;
+
+static void handler(void) {
+    IRQTRACE_Enter(latencies[current][0]);
+    DWT->CYCCNT += 100;
+    IRQTRACE_Exit();
+}
+
+static void output(const void *data, unsigned int len, void *ctx) {
+    TEST_CHECK(exportedLength + len <= sizeof(exported));
+    memcpy(exported + exportedLength, data, len);
+    exportedLength += len;
+}
+
+int main(void) {
+    const uint8_t *event;
+    char line[160];
+    unsigned int saturated = 0, known = 0;
+    FILE *file;
+
+    IRQTRACE_Init();
+    for(current = 0; current < COUNT(latencies); current++) {
+        DWT->CYCCNT += 1000;
+        host_run_handler(16 + TIMER0_IRQn, handler);
+    }
+    IRQTRACE_Export(output, 0);
+    TEST_EQUAL(exportedLength, sizeof(exported));
+
+    // Entries are every other event, the latency in their last two bytes
+    for(current = 0; current < COUNT(latencies); current++) {
+        event = exported + HEADER_SIZE + 2 * current * EVENT_SIZE;
+        TEST_EQUAL(event[4], 16 + TIMER0_IRQn);
+        TEST_EQUAL(event[5], IRQTRACE_EVENT_ENTER);
+        TEST_EQUAL(event[6] | event[7] << 8, latencies[current][1]);
+    }
+    // The statistics keep the latencies in full, the unknown one aside
+    TEST_EQUAL(IRQTRACE_GetStats(16 + TIMER0_IRQn)->latencyCount, COUNT(latencies) - 1);
+    TEST_EQUAL(IRQTRACE_GetStats(16 + TIMER0_IRQn)->latencyMax, 0x123456);
+
+    file = fopen(TEST_EXPORT, "wb");
+    TEST_CHECK(file && fwrite(exported, 1, exportedLength, file) == exportedLength && fclose(file) == 0);
+    file = popen(TEST_DECODER, "r");
+    TEST_CHECK(file);
+    while(fgets(line, sizeof(line), file)) {
+        if(strstr(line, "> TIMER0")) {
+            known += strstr(line, "latency") != 0;
+            saturated += strstr(line, "latency >=") != 0;
+        }
+    }
+    TEST_EQUAL(pclose(file), 0);
+    TEST_EQUAL(known, COUNT(latencies) - 1);
+    TEST_EQUAL(saturated, 3);
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file     test_kernel.c
+ * @brief    Host test of the preemptive kernel: priority inheritance, queues, interrupts
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * kernel.c, swtimer.c and sched.c as built for the target, on the ucontext port of
+ * kernel_host.c and the simulated TIMER0 of timer_sim.c. What the threads do is logged with
+ * the time, in ms, and compared.
+ *
+ **/
+
+#include <string.h>
+
+#include "kernel.h"
+#include "kernel_host.h"
+#include "timer_sim.h"
+#include "test.h"
+
+#define MS                                  ((uint64_t)TIMER_TICK_HZ / 1000)
+#define TEST_THREADS                        4
+
+static uint32_t stacks[TEST_THREADS][KERNEL_HOST_STACK_WORDS] __attribute__((aligned(16)));
+static kernel_thread threads[TEST_THREADS];
+static char logText[512];
+static unsigned int logLength;
+
+#define LOG(...)                            (logLength += snprintf(logText + logLength, sizeof(logText) - logLength, __VA_ARGS__))
+
+static unsigned int now_ms(void) {
+    return (unsigned int)(TIMER0_GetTicks64() / MS);
+}
+
+static void check_log(const char *expected) {
+    if(strcmp(logText, expected)) {
+        fprintf(stderr, "log \"%s\", expected \"%s\"\n", logText, expected);
+        exit(1);
+    }
+}
+
+static void setup(void) {
+    timer_sim_reset(0);
+    SWTIMER_Init();
+    KERNEL_Init();
+    logLength = 0;
+    logText[0] = 0;
+}
+
+static kernel_thread *create(unsigned int index, kernel_entry entry, unsigned int priority) {
+    TEST_EQUAL(KERNEL_CreateThread(&threads[index], stacks[index], KERNEL_HOST_STACK_WORDS, entry, 0, priority),
+               KERNEL_OPER_SUCCESS);
+    return &threads[index];
+}
+
+/* Priority inheritance through a chain: H waits for M's mutex, M for L's */
+
+static kernel_mutex mutex1, mutex2;
+static kernel_thread *low, *middle, *high;
+
+static void low_entry(void *arg) {
+    TEST_EQUAL(KERNEL_MutexLock(&mutex1), KERNEL_OPER_SUCCESS);
+    LOG("L+1@%u ", now_ms());
+    KERNEL_Sleep(5);
+    // Raised by M, then through M by H
+    TEST_EQUAL(low->priority, 10);
+    TEST_EQUAL(KERNEL_MutexUnlock(&mutex1), KERNEL_OPER_SUCCESS);
+    TEST_EQUAL(low->priority, 2);
+    LOG("L-1@%u ", now_ms());
+}
+
+static void middle_entry(void *arg) {
+    TEST_EQUAL(KERNEL_MutexLock(&mutex2), KERNEL_OPER_SUCCESS);
+    KERNEL_Sleep(1);
+    KERNEL_MutexLock(&mutex1);
+    LOG("M+1@%u ", now_ms());
+    TEST_EQUAL(middle->priority, 10);
+    TEST_EQUAL(KERNEL_MutexUnlock(&mutex1), KERNEL_OPER_SUCCESS);
+    TEST_EQUAL(KERNEL_MutexUnlock(&mutex2), KERNEL_OPER_SUCCESS);
+    TEST_EQUAL(middle->priority, 5);
+    LOG("M-@%u ", now_ms());
+}
+
+static void high_entry(void *arg) {
+    KERNEL_Sleep(2);
+    KERNEL_MutexLock(&mutex2);
+    LOG("H+2@%u ", now_ms());
+    TEST_EQUAL(KERNEL_MutexUnlock(&mutex2), KERNEL_OPER_SUCCESS);
+    // Not the owner any more
+    TEST_EQUAL(KERNEL_MutexUnlock(&mutex2), KERNEL_OPER_FAIL);
+}
+
+static void test_inheritance(void) {
+    setup();
+    KERNEL_MutexInit(&mutex1);
+    KERNEL_MutexInit(&mutex2);
+    low = create(0, low_entry, 2);
+    middle = create(1, middle_entry, 5);
+    high = create(2, high_entry, 10);
+    KERNEL_Start();
+    // L runs at H's priority from 2 ms; each unlock hands over and drops the priority at once
+    check_log("L+1@0 M+1@5 H+2@5 M-@5 L-1@5 ");
+}
+
+/* Queues: timeouts, senders blocked on a full queue, items from an interrupt */
+
+static kernel_queue queue;
+static int queueBuffer[2];
+static swtimer interrupt;
+
+static void receiver_entry(void *arg) {
+    unsigned int i, result;
+    int item;
+
+    for(i = 0; i < 8; i++) {
+        item = -1;
+        result = KERNEL_QueueReceive(&queue, &item, (i < 2)? 3 : KERNEL_WAIT_FOREVER);
+        LOG("R%u:%d@%u ", result, item, now_ms());
+    }
+}
+
+static void sender_entry(void *arg) {
+    int item;
+
+    KERNEL_Sleep(10);
+    for(item = 0; item < 5; item++) {
+        TEST_EQUAL(KERNEL_QueueSend(&queue, &item, KERNEL_WAIT_FOREVER), KERNEL_OPER_SUCCESS);
+    }
+    LOG("S@%u ", now_ms());
+    // Full, the receiver is gone
+    KERNEL_Sleep(30);
+    TEST_EQUAL(KERNEL_QueueSend(&queue, &item, 0), KERNEL_OPER_SUCCESS);
+    TEST_EQUAL(KERNEL_QueueSend(&queue, &item, 0), KERNEL_OPER_SUCCESS);
+    TEST_EQUAL(KERNEL_QueueSend(&queue, &item, 0), KERNEL_OPER_TIMEOUT);
+    TEST_EQUAL(KERNEL_QueueSend(&queue, &item, 4), KERNEL_OPER_TIMEOUT);
+    LOG("S-@%u ", now_ms());
+}
+
+static void interrupt_send(swtimer *timer, void *ctx) {
+    int item = 77;
+
+    TEST_CHECK(__get_IPSR() == 16 + TIMER0_IRQn);
+    TEST_EQUAL(KERNEL_QueueSendFromISR(&queue, &item), KERNEL_OPER_SUCCESS);
+}
+
+static void test_queues(void) {
+    setup();
+    TEST_EQUAL(KERNEL_QueueInit(&queue, queueBuffer, sizeof(int), 0), KERNEL_OPER_FAIL);
+    TEST_EQUAL(KERNEL_QueueInit(&queue, queueBuffer, sizeof(int), 2), KERNEL_OPER_SUCCESS);
+    create(0, receiver_entry, 8);
+    create(1, sender_entry, 3);
+    SWTIMER_Setup(&interrupt, interrupt_send, 0);
+    SWTIMER_Start(&interrupt, 20000, 0);
+    KERNEL_Start();
+    // Each send wakes the higher priority receiver at once, the item from the interrupt too
+    check_log("R2:-1@3 R2:-1@6 R0:0@10 R0:1@10 R0:2@10 R0:3@10 R0:4@10 S@10 R0:77@20 S-@44 ");
+}
+
+/* Outside a thread */
+
+static void test_no_thread(void) {
+    int item = 0;
+
+    setup();
+    KERNEL_MutexInit(&mutex1);
+    TEST_EQUAL(KERNEL_QueueInit(&queue, queueBuffer, sizeof(int), 2), KERNEL_OPER_SUCCESS);
+    TEST_CHECK(KERNEL_Self() == 0);
+    TEST_EQUAL(KERNEL_MutexLock(&mutex1), KERNEL_OPER_FAIL);
+    TEST_EQUAL(KERNEL_MutexUnlock(&mutex1), KERNEL_OPER_FAIL);
+    TEST_EQUAL(KERNEL_QueueSend(&queue, &item, 0), KERNEL_OPER_FAIL);
+    TEST_EQUAL(KERNEL_QueueReceive(&queue, &item, KERNEL_WAIT_FOREVER), KERNEL_OPER_FAIL);
+    KERNEL_Yield();
+    KERNEL_Sleep(1);
+    TEST_EQUAL(KERNEL_CreateThread(&threads[0], stacks[0], KERNEL_HOST_STACK_WORDS, 0, 0, 0), KERNEL_OPER_FAIL);
+    TEST_EQUAL(KERNEL_CreateThread(&threads[0], stacks[0], KERNEL_HOST_STACK_WORDS, 0, 0, KERNEL_PRIORITIES),
+               KERNEL_OPER_FAIL);
+}
+
+int main(void) {
+    test_no_thread();
+    test_inheritance();
+    test_queues();
+    printf("kernel: %lu switches in the last test\n", kernel_host_switches());
+
+    return 0;
+}
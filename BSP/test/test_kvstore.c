@@ -0,0 +1,196 @@
+/**
+ * @file     test_kvstore.c
+ * @brief    Host test of the key/value store: power cuts, stale logs, update rate and wear
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * kvstore.c and flash_drv.c as built for the target, over the simulated EEPROM of eeprom_sim.c.
+ *
+ **/
+
+#include <string.h>
+
+#include "kvstore.h"
+#include "eeprom_sim.h"
+#include "test.h"
+
+#define TEST_KEYS                           20
+#define TEST_ROUNDS                         3000
+#define TEST_BENCH_UPDATES                  20000
+#define I2C_BIT_HZ                          400000      // Fast mode
+#define I2C_BITS_PER_BYTE                   9           // With the acknowledge
+
+/// What the store must hold
+typedef struct model_t {
+    unsigned char value[KVS_MAX_VALUE_SIZE];
+    unsigned int size;                      //!< 0: not stored
+} model;
+
+static model expected[TEST_KEYS];
+
+static void mount(void) {
+    FLASH_Init();
+    TEST_EQUAL(KVS_Init(), KVS_OPER_SUCCESS);
+}
+
+static void check_model(void) {
+    unsigned char value[KVS_MAX_VALUE_SIZE];
+    unsigned int size;
+    unsigned int key;
+
+    for(key = 0; key < TEST_KEYS; key++) {
+        size = sizeof(value);
+        if(expected[key].size) {
+            TEST_EQUAL(KVS_Get(key, value, &size), KVS_OPER_SUCCESS);
+            TEST_EQUAL(size, expected[key].size);
+            TEST_CHECK(memcmp(value, expected[key].value, size) == 0);
+        }
+        else {
+            TEST_EQUAL(KVS_Get(key, value, &size), KVS_NOT_FOUND);
+        }
+    }
+}
+
+/**
+ * Random sets and deletes, a quarter of them cut by a power loss in one of their first page
+ * programs. After a cut, the key holds either its old or its new value, every other key is intact.
+ */
+static void test_power_cuts(void) {
+    unsigned char value[KVS_MAX_VALUE_SIZE], stored[KVS_MAX_VALUE_SIZE];
+    unsigned int size, storedSize, key, retVal, i;
+    int round, remove;
+
+    eeprom_sim_reset(&FLASH_24LC64);
+    memset(expected, 0, sizeof(expected));
+    srand(99);
+    mount();
+
+    for(round = 0; round < TEST_ROUNDS; round++) {
+        key = rand() % TEST_KEYS;
+        size = 1 + rand() % KVS_MAX_VALUE_SIZE;
+        for(i = 0; i < size; i++) {
+            value[i] = rand();
+        }
+        remove = (rand() % 8 == 0);
+        eeprom_sim_cut_after((rand() % 4 == 0)? rand() % 3 : -1);
+
+        if(setjmp(eeprom_sim_cut) == 0) {
+            retVal = remove? KVS_Delete(key) : KVS_Set(key, value, size);
+            eeprom_sim_cut_after(-1);
+            if(retVal == KVS_OPER_SUCCESS) {
+                expected[key].size = remove? 0 : size;
+                memcpy(expected[key].value, value, size);
+            }
+            else {
+                TEST_CHECK(remove && retVal == KVS_NOT_FOUND);
+            }
+        }
+        else {
+            // Power back: the interrupted update either made it or not
+            mount();
+            storedSize = sizeof(stored);
+            retVal = KVS_Get(key, stored, &storedSize);
+            if(remove && retVal == KVS_NOT_FOUND) {
+                expected[key].size = 0;
+            }
+            else if(!remove && retVal == KVS_OPER_SUCCESS && storedSize == size && memcmp(stored, value, size) == 0) {
+                expected[key].size = size;
+                memcpy(expected[key].value, value, size);
+            }
+        }
+        check_model();
+
+        if(rand() % 50 == 0) {
+            mount();
+            check_model();
+        }
+    }
+    TEST_CHECK(eeprom_sim_get_stats()->cuts > 0);
+}
+
+/**
+ * Both headers lost while the banks still hold valid records: the store formats, and neither
+ * the format nor the compactions that follow bring the old records back
+ */
+static void test_stale_log(void) {
+    unsigned char value[KVS_MAX_VALUE_SIZE];
+    unsigned int size, key, i;
+
+    eeprom_sim_reset(&FLASH_24LC64);
+    mount();
+    // Generation 1 in bank 0, then 2 in bank 1, both with keys 1 to 10
+    for(key = 1; key <= 10; key++) {
+        TEST_EQUAL(KVS_Set(key, &key, sizeof(key)), KVS_OPER_SUCCESS);
+    }
+    TEST_EQUAL(KVS_Compact(), KVS_OPER_SUCCESS);
+    for(key = 1; key <= 10; key++) {
+        TEST_EQUAL(KVS_Set(key, &key, 1), KVS_OPER_SUCCESS);
+    }
+
+    for(i = 0; i < 2; i++) {
+        memset(eeprom_sim_memory() + KVS_BASE_ADDR + i * KVS_BANK_SIZE, 0, 2);
+    }
+    mount();
+    size = sizeof(value);
+    TEST_EQUAL(KVS_Get(1, value, &size), KVS_NOT_FOUND);
+
+    // Generation 1 again, a record over the old ones
+    key = 20;
+    TEST_EQUAL(KVS_Set(key, &key, sizeof(key)), KVS_OPER_SUCCESS);
+    mount();
+    for(key = 1; key <= 10; key++) {
+        size = sizeof(value);
+        TEST_EQUAL(KVS_Get(key, value, &size), KVS_NOT_FOUND);
+    }
+
+    // Generation 2 again, in bank 1
+    TEST_EQUAL(KVS_Compact(), KVS_OPER_SUCCESS);
+    mount();
+    for(key = 1; key <= 10; key++) {
+        size = sizeof(value);
+        TEST_EQUAL(KVS_Get(key, value, &size), KVS_NOT_FOUND);
+    }
+    size = sizeof(value);
+    TEST_EQUAL(KVS_Get(20, value, &size), KVS_OPER_SUCCESS);
+}
+
+/**
+ * Counter updates spread over a few keys: update rate from the bus traffic and the write
+ * cycles, and how evenly the store wears its region
+ */
+static void bench_updates(void) {
+    const eeprom_sim_stats *stats = eeprom_sim_get_stats();
+    unsigned long maxWear = 0, totalWear = 0, wear;
+    uint32_t counter;
+    unsigned int addr, i;
+    double seconds;
+
+    eeprom_sim_reset(&FLASH_24LC64);
+    mount();
+    for(i = 0; i < TEST_BENCH_UPDATES; i++) {
+        counter = i;
+        TEST_EQUAL(KVS_Set(i % 4, &counter, sizeof(counter)), KVS_OPER_SUCCESS);
+    }
+
+    for(addr = KVS_BASE_ADDR; addr < KVS_BASE_ADDR + KVS_SIZE; addr++) {
+        wear = eeprom_sim_wear(addr);
+        totalWear += wear;
+        if(wear > maxWear) {
+            maxWear = wear;
+        }
+    }
+    seconds = (double)stats->busBytes * I2C_BITS_PER_BYTE / I2C_BIT_HZ
+        + stats->pagePrograms * FLASH_24LC64.twrMs / 1000.0;
+    printf("kvstore: %u updates, %lu page programs, %.0f updates/s at 400 kHz and tWR %u ms\n",
+           TEST_BENCH_UPDATES, stats->pagePrograms, TEST_BENCH_UPDATES / seconds, FLASH_24LC64.twrMs);
+    printf("kvstore: wear over %u bytes: max %lu, mean %.1f, %.0f updates per write cycle of the most worn byte\n",
+           (unsigned int)KVS_SIZE, maxWear, (double)totalWear / KVS_SIZE, (double)TEST_BENCH_UPDATES / maxWear);
+}
+
+int main(void) {
+    test_power_cuts();
+    test_stale_log();
+    bench_updates();
+
+    return 0;
+}
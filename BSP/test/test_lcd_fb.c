@@ -0,0 +1,130 @@
+/**
+ * @file     test_lcd_fb.c
+ * @brief    Host test of the LCD framebuffer: what reaches the panel, tearing, bus time, frame dumps
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * lcd_fb.c as built for the target, over the simulated panel of panel_sim.c. The frames the
+ * panel shows are written to build/lcd_*.ppm.
+ *
+ **/
+
+#include <string.h>
+
+#include "lcd_fb.h"
+#include "panel_sim.h"
+#include "test.h"
+
+#define TEST_ROUNDS                         200
+#define TEST_DUMP_SCALE                     3
+#define TEST_DUMP_DIR                       "build/"
+
+void Delay(uint32_t delay) {
+}
+
+static unsigned int panel_matches(void) {
+    return memcmp(panel_sim_ram(), LCDFB_GetBuffer(), LCD_FB_WIDTH * LCD_FB_HEIGHT) == 0;
+}
+
+static void dump(const char *name) {
+    char path[64];
+
+    snprintf(path, sizeof(path), TEST_DUMP_DIR "lcd_%s.ppm", name);
+    TEST_EQUAL(panel_sim_write_ppm(path, TEST_DUMP_SCALE), 0);
+}
+
+static void init(void) {
+    panel_sim_reset();
+    TEST_EQUAL(LCDFB_Init(), LCD_FB_OPER_SUCCESS);
+    TEST_CHECK(panel_matches());
+}
+
+/**
+ * Random rectangles and pixels, flushed now and then: after each flush the panel shows the frame
+ */
+static void test_random_draws(void) {
+    unsigned int round, i;
+    int x, y;
+
+    init();
+    srand(37);
+    for(round = 0; round < TEST_ROUNDS; round++) {
+        for(i = rand() % 12; i > 0; i--) {
+            x = rand() % (LCD_FB_WIDTH + 20) - 10;
+            y = rand() % (LCD_FB_HEIGHT + 20) - 10;
+            if(rand() % 3) {
+                LCDFB_FillRect(x, y, rand() % 40, rand() % 40, rand());
+            }
+            else {
+                LCDFB_SetPixel(x, y, rand());
+            }
+        }
+        TEST_EQUAL(LCDFB_Flush(), LCD_FB_OPER_SUCCESS);
+        TEST_CHECK(!LCDFB_IsBusy());
+        TEST_CHECK(panel_matches());
+    }
+    dump("random");
+}
+
+/**
+ * Drawing while a flush is on the wire may tear, as documented; the next flush repairs it
+ */
+static void test_draw_during_flush(void) {
+    unsigned int torn;
+
+    init();
+    LCDFB_FillRect(0, 0, LCD_FB_WIDTH, LCD_FB_HEIGHT, LCD_RGB(0, 0, 255));
+    panel_sim_set_manual(1);
+    TEST_EQUAL(LCDFB_Flush(), LCD_FB_OPER_SUCCESS);
+    TEST_CHECK(LCDFB_IsBusy());
+    TEST_EQUAL(LCDFB_Flush(), LCD_FB_OPER_BUSY);
+
+    // A few rows out, a band across the whole height is drawn
+    TEST_CHECK(panel_sim_step());
+    TEST_CHECK(panel_sim_step());
+    LCDFB_FillRect(40, 0, 50, LCD_FB_HEIGHT, LCD_RGB(255, 255, 0));
+    while(panel_sim_step());
+    TEST_CHECK(!LCDFB_IsBusy());
+    torn = !panel_matches();
+    dump("torn");
+
+    panel_sim_set_manual(0);
+    TEST_EQUAL(LCDFB_Flush(), LCD_FB_OPER_SUCCESS);
+    TEST_CHECK(!LCDFB_IsBusy());
+    TEST_CHECK(panel_matches());
+    TEST_CHECK(torn);
+    dump("repaired");
+}
+
+/**
+ * Bus time of a full frame against a small update
+ */
+static void bench_updates(void) {
+    unsigned long fullUs, partialUs;
+
+    init();
+    panel_sim_reset();
+    LCDFB_FillRect(0, 0, LCD_FB_WIDTH, LCD_FB_HEIGHT, LCD_RGB(0, 128, 0));
+    LCDFB_Flush();
+    fullUs = panel_sim_bus_us(LCD_FB_FREQUENCY);
+    TEST_CHECK(panel_matches());
+
+    panel_sim_reset();
+    LCDFB_FillRect(10, 10, 24, 16, LCD_WHITE);
+    LCDFB_SetPixel(120, 120, LCD_WHITE);
+    LCDFB_Flush();
+    partialUs = panel_sim_bus_us(LCD_FB_FREQUENCY);
+    TEST_EQUAL(panel_sim_get_stats()->ramWrites, 24 * 16 + 1);
+    TEST_CHECK(partialUs < fullUs / 20);
+
+    printf("lcd_fb: full frame %lu us, 24x16 rectangle and a pixel %lu us, at %u Hz\n",
+           fullUs, partialUs, LCD_FB_FREQUENCY);
+}
+
+int main(void) {
+    test_random_draws();
+    test_draw_during_flush();
+    bench_updates();
+
+    return 0;
+}
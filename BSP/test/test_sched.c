@@ -0,0 +1,197 @@
+/**
+ * @file     test_sched.c
+ * @brief    Host test of the cooperative scheduler: run order, nested waits, timed posts
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * sched.c and swtimer.c as built for the target, over the simulated TIMER0 of timer_sim.c:
+ * the clock moves when the scheduler sleeps. What the tasks do is logged and compared.
+ *
+ **/
+
+#include <string.h>
+
+#include "sched.h"
+#include "timer_sim.h"
+#include "test.h"
+
+#define MS                                  ((uint64_t)TIMER_TICK_HZ / 1000)
+
+static char logText[512];
+static unsigned int logLength;
+
+static sched_task taskA, taskB, taskC;
+static swtimer interrupt;
+static uint64_t delayEnd[SCHED_PRIORITIES];
+
+static char task_name(const sched_task *task) {
+    return (task == &taskA)? 'A' : (task == &taskB)? 'B' : (task == &taskC)? 'C' : '?';
+}
+
+static void log_add(const char *text, const sched_task *task, uint32_t events) {
+    logLength += snprintf(logText + logLength, sizeof(logText) - logLength, "%s%c%x ",
+                          text, task_name(task), (unsigned int)events);
+}
+
+static void check_log(const char *expected) {
+    if(strcmp(logText, expected)) {
+        fprintf(stderr, "log \"%s\", expected \"%s\"\n", logText, expected);
+        exit(1);
+    }
+    logLength = 0;
+    logText[0] = 0;
+}
+
+static void setup(void) {
+    timer_sim_reset(0);
+    SWTIMER_Init();
+    SCHED_Init();
+    logLength = 0;
+    logText[0] = 0;
+}
+
+static void logger(sched_task *task, uint32_t events) {
+    log_add("", task, events);
+}
+
+/**
+ * Highest priority first, FIFO within a priority, flags merged until the task runs
+ */
+static void test_order(void) {
+    sched_task rejected;
+
+    setup();
+    TEST_EQUAL(SCHED_AddTask(&taskA, logger, 0, 3), SCHED_OPER_SUCCESS);
+    TEST_EQUAL(SCHED_AddTask(&taskB, logger, 0, 0), SCHED_OPER_SUCCESS);
+    TEST_EQUAL(SCHED_AddTask(&taskC, logger, 0, SCHED_PRIORITIES - 1), SCHED_OPER_SUCCESS);
+    TEST_EQUAL(SCHED_AddTask(&rejected, logger, 0, SCHED_PRIORITIES), SCHED_OPER_FAIL);
+    TEST_EQUAL(SCHED_AddTask(&rejected, logger, 0, ~0U), SCHED_OPER_FAIL);
+
+    SCHED_Post(&taskB, 0x1);
+    SCHED_Post(&taskA, 0x1);
+    SCHED_Post(&taskC, 0x4);
+    SCHED_Post(&taskA, 0x8);
+    SCHED_Post(&taskB, 0x2);
+    while(SCHED_RunOnce());
+    check_log("C4 A9 B3 ");
+    TEST_EQUAL(SCHED_RunOnce(), 0);
+}
+
+static unsigned int reposts;
+
+static void reposting(sched_task *task, uint32_t events) {
+    log_add("", task, events);
+    if(reposts) {
+        reposts--;
+        SCHED_Post(task, events << 1);
+    }
+}
+
+/**
+ * A task posting to itself is queued again when it returns, behind the others of its
+ * priority; SCHED_Yield() runs only what is ready when called
+ */
+static void test_repost(void) {
+    setup();
+    SCHED_AddTask(&taskA, reposting, 0, 2);
+    SCHED_AddTask(&taskB, logger, 0, 2);
+    reposts = 5;
+    SCHED_Post(&taskA, 0x1);
+    SCHED_Post(&taskB, 0x1);
+    SCHED_Yield();
+    check_log("A1 B1 ");
+    SCHED_Yield();
+    check_log("A2 ");
+    while(SCHED_RunOnce());
+    check_log("A4 A8 A10 A20 ");
+}
+
+/**
+ * On event 0x1, waits 5 ms (A) or 2 ms (B); A posts to B and to itself first, B arms the
+ * interrupt
+ */
+static void waiter(sched_task *task, uint32_t events) {
+    unsigned int ms = (task == &taskA)? 5 : 2;
+    uint64_t start = TIMER0_GetTicks64();
+
+    log_add("+", task, events);
+    if(events & 0x1) {
+        if(task == &taskA) {
+            SCHED_Post(&taskB, 0x1);
+            SCHED_Post(&taskA, 0x2);
+        }
+        else {
+            SWTIMER_Start(&interrupt, 1000, 0);
+        }
+        SCHED_Delay(ms);
+        delayEnd[task->priority] = TIMER0_GetTicks64();
+        TEST_CHECK(delayEnd[task->priority] >= start + ms * MS);
+    }
+    log_add("-", task, events);
+}
+
+static void post_c(swtimer *timer, void *ctx) {
+    TEST_CHECK(__get_IPSR() == 16 + TIMER0_IRQn);
+    SCHED_Post(&taskC, 0x4);
+}
+
+/**
+ * A waits 5 ms; B runs meanwhile and waits 2 ms, nested; C is posted from an interrupt 1 ms in
+ * and runs nested in B's wait. A, posted while it waits, does not run nested in itself.
+ */
+static void test_nested_waits(void) {
+    setup();
+    SCHED_AddTask(&taskA, waiter, 0, 1);
+    SCHED_AddTask(&taskB, waiter, 0, 2);
+    SCHED_AddTask(&taskC, logger, 0, 3);
+    SWTIMER_Setup(&interrupt, post_c, 0);
+
+    SCHED_Post(&taskA, 0x1);
+    TEST_EQUAL(SCHED_RunOnce(), 1);
+    check_log("+A1 +B1 C4 -B1 -A1 ");
+    // B's wait ends on time, A's once B has returned: it is nested on A's stack
+    TEST_CHECK(delayEnd[2] < delayEnd[1]);
+    TEST_CHECK(delayEnd[1] - 5 * MS < MS);
+
+    // A's post made during its wait runs after it
+    TEST_EQUAL(SCHED_RunOnce(), 1);
+    check_log("+A2 -A2 ");
+    TEST_EQUAL(SCHED_RunOnce(), 0);
+}
+
+/**
+ * Timed posts: on time, replaced by a later one, cancelled. The scheduler sleeps in between.
+ */
+static void test_timed_posts(void) {
+    uint64_t start;
+
+    setup();
+    SCHED_AddTask(&taskA, logger, 0, 1);
+    SCHED_AddTask(&taskB, logger, 0, 1);
+    SCHED_AddTask(&taskC, logger, 0, 1);
+    start = TIMER0_GetTicks64();
+    SCHED_PostIn(&taskA, 0x1, 3500);
+    SCHED_PostIn(&taskB, 0x1, 1000);
+    SCHED_PostIn(&taskB, 0x2, 2000);
+    SCHED_PostIn(&taskC, 0x1, 1500);
+    SCHED_CancelPost(&taskC);
+
+    SCHED_Delay(1);
+    check_log("");
+    SCHED_Delay(2);
+    check_log("B2 ");
+    SCHED_Delay(1);
+    check_log("A1 ");
+    SCHED_Delay(10);
+    check_log("");
+    TEST_CHECK(TIMER0_GetTicks64() - start >= 14 * MS);
+}
+
+int main(void) {
+    test_order();
+    test_repost();
+    test_nested_waits();
+    test_timed_posts();
+
+    return 0;
+}
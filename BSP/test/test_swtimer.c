@@ -0,0 +1,232 @@
+/**
+ * @file     test_swtimer.c
+ * @brief    Host test of the software timers: cascading, parked timers, the 32-bit match wrap
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * swtimer.c as built for the target, over the simulated TIMER0 of timer_sim.c. Every expiry is
+ * checked against the time it was asked for: never early, at most one unit late.
+ *
+ **/
+
+#include <string.h>
+
+#include "swtimer.h"
+#include "timer_sim.h"
+#include "test.h"
+
+#define UNIT                                ((uint64_t)0x1 << SWTIMER_UNIT_SHIFT)
+#define SPAN                                (UNIT << (SWTIMER_SLOT_BITS * SWTIMER_LEVELS))  // Ticks
+#define MAX_LATE                            (UNIT + TIMER_MIN_LEAD)
+#define WRAP                                ((uint64_t)0x1 << 32)
+#define TEST_TIMERS                         300
+#define TEST_ROUNDS                         20000
+
+/// A timer and what it was asked for
+typedef struct probe_t {
+    swtimer timer;
+    uint64_t requested;                     //!< Ticks, first expiry
+    uint64_t fired;                         //!< Ticks, last expiry
+    uint32_t periodUs;
+    unsigned int count;                     //!< Expiries
+    unsigned int restarts;                  //!< By restart_from_callback()
+} probe;
+
+static probe probes[TEST_TIMERS];
+
+static void probe_expired(swtimer *timer, void *ctx) {
+    probe *p = ctx;
+    uint64_t now = TIMER0_GetTicks64();
+    uint64_t due = p->requested + (uint64_t)p->count * p->periodUs * TIMER_TICKS_PER_US;
+
+    TEST_CHECK(timer == &p->timer);
+    TEST_CHECK(now >= due);
+    // Periods are rounded up to whole units, the lateness adds up
+    TEST_CHECK(now - due <= MAX_LATE + (uint64_t)p->count * UNIT);
+    p->fired = now;
+    p->count++;
+}
+
+static void start_at(probe *p, uint64_t ticks) {
+    p->requested = ticks;
+    p->periodUs = 0;
+    p->count = 0;
+    SWTIMER_StartAt(&p->timer, ticks);
+}
+
+static void setup(uint64_t base) {
+    unsigned int i;
+
+    timer_sim_reset(base);
+    SWTIMER_Init();
+    memset(probes, 0, sizeof(probes));
+    for(i = 0; i < TEST_TIMERS; i++) {
+        SWTIMER_Setup(&probes[i].timer, probe_expired, &probes[i]);
+    }
+}
+
+/**
+ * Timers on both sides of every level boundary, from a time base that is not aligned on any
+ * level: each one is moved down level by level and expires on time
+ */
+static void test_cascade(uint64_t base) {
+    uint64_t units;
+    unsigned int level, i, n = 0;
+
+    setup(base);
+    for(level = 0; level < SWTIMER_LEVELS; level++) {
+        units = (uint64_t)0x1 << (SWTIMER_SLOT_BITS * level);
+        start_at(&probes[n++], base + (units - 1) * UNIT);
+        start_at(&probes[n++], base + units * UNIT);
+        start_at(&probes[n++], base + (units + 1) * UNIT + 1);
+        start_at(&probes[n++], base + units * SWTIMER_SLOTS * UNIT - 1);
+    }
+    for(i = n; i < 100; i++) {
+        start_at(&probes[i], base + (uint64_t)rand() * rand() % SPAN);
+    }
+    n = i;
+
+    timer_sim_run_until(base + SPAN + SPAN / 2);
+    for(i = 0; i < n; i++) {
+        TEST_EQUAL(probes[i].count, 1);
+        TEST_CHECK(!SWTIMER_IsActive(&probes[i].timer));
+    }
+    TEST_EQUAL(timer_sim_next_match(), ~(uint64_t)0);
+}
+
+/**
+ * Timers beyond the span of the wheel are parked in its farthest slot and filed again as it
+ * comes up, while nearer timers run as usual
+ */
+static void test_parked(void) {
+    uint64_t base = 12345678, end;
+    unsigned long interrupts;
+
+    setup(base);
+    start_at(&probes[0], base + 3 * SPAN + 777);
+    start_at(&probes[1], base + SPAN + 1);
+    SWTIMER_Start(&probes[2].timer, 4000000000UL, 0);      // Microseconds, beyond the span as well
+    probes[2].requested = base + 4000000000ULL * TIMER_TICKS_PER_US;
+    start_at(&probes[3], base + 5 * UNIT);
+
+    timer_sim_run_until(base + 10 * UNIT);
+    TEST_EQUAL(probes[3].count, 1);
+    TEST_EQUAL(probes[0].count + probes[1].count + probes[2].count, 0);
+
+    end = probes[2].requested + UNIT + TIMER_MIN_LEAD;
+    timer_sim_run_until(end);
+    TEST_EQUAL(probes[0].count, 1);
+    TEST_EQUAL(probes[1].count, 1);
+    TEST_EQUAL(probes[2].count, 1);
+
+    // A parked timer costs one interrupt per counter wrap, and a few more for its moves down
+    interrupts = timer_sim_get_stats()->interrupts;
+    printf("swtimer: %lu interrupts over %llu counter wraps for 4 timers, 3 of them parked\n",
+           interrupts, (unsigned long long)((end - base) / WRAP));
+    TEST_CHECK(interrupts <= (end - base) / WRAP + 1 + 4 * SWTIMER_LEVELS * 3);
+}
+
+/**
+ * Only the low 32 bits of the time base are matched: an expiry more than a counter wrap away
+ * gets an early, empty interrupt first. Also across the wrap of the low word itself.
+ */
+static void test_match_wrap(void) {
+    uint64_t base = WRAP - 3 * UNIT - 5;
+
+    setup(base);
+    start_at(&probes[0], base + WRAP + 100 * UNIT);
+    TEST_CHECK(timer_sim_next_match() < probes[0].requested);
+    start_at(&probes[1], base + 6 * UNIT);      // Across 2^32
+    timer_sim_run_until(base + 2 * WRAP);
+    TEST_EQUAL(probes[0].count, 1);
+    TEST_EQUAL(probes[1].count, 1);
+    TEST_CHECK(probes[1].fired > WRAP);
+
+    // A match value already passed only comes up after a wrap: swtimer must never arm one
+    setup(WRAP - 10);
+    start_at(&probes[0], WRAP - 10);
+    timer_sim_run_until(WRAP + UNIT + TIMER_MIN_LEAD);
+    TEST_EQUAL(probes[0].count, 1);
+}
+
+/**
+ * Starts its timer again from the callback, a few times, on the shortest delay: the match has
+ * to be pushed out by TIMER_MIN_LEAD
+ */
+static void restart_from_callback(swtimer *timer, void *ctx) {
+    probe *p = ctx;
+
+    probe_expired(timer, ctx);
+    if(!p->periodUs && p->restarts < 3) {
+        p->restarts++;
+        p->requested = TIMER0_GetTicks64() + 1;
+        p->count = 0;
+        SWTIMER_StartAt(timer, p->requested);
+    }
+}
+
+/**
+ * Random starts, restarts and stops, some periodic, some from the callbacks
+ */
+static void test_random(void) {
+    uint64_t base = 0xFFF00000ULL, now;
+    unsigned int round, i, done;
+    probe *p;
+
+    setup(base);
+    SWTIMER_Setup(&probes[0].timer, restart_from_callback, &probes[0]);
+    for(round = 0; round < TEST_ROUNDS; round++) {
+        p = &probes[rand() % TEST_TIMERS];
+        now = TIMER0_GetTicks64();
+        switch(rand() % 4) {
+        case 0:
+            SWTIMER_Stop(&p->timer);
+            TEST_CHECK(!SWTIMER_IsActive(&p->timer));
+            break;
+        case 1:
+            p->periodUs = 0;
+            p->count = 0;
+            p->requested = now + (uint64_t)(rand() % 5000) * TIMER_TICKS_PER_US;
+            SWTIMER_Start(&p->timer, (uint32_t)((p->requested - now) / TIMER_TICKS_PER_US), 0);
+            break;
+        case 2:
+            p->periodUs = 100 + rand() % 3000;
+            p->count = 0;
+            p->requested = now + (uint64_t)p->periodUs * TIMER_TICKS_PER_US;
+            SWTIMER_Start(&p->timer, p->periodUs, p->periodUs);
+            break;
+        default:
+            start_at(p, now + (uint64_t)rand() * 64 % (SPAN / 16));
+            break;
+        }
+        timer_sim_run_until(now + rand() % (4 * UNIT));
+    }
+
+    // Every one-shot still started expires, then the wheel is empty
+    for(i = 0; i < TEST_TIMERS; i++) {
+        if(probes[i].periodUs) {
+            SWTIMER_Stop(&probes[i].timer);
+        }
+    }
+    timer_sim_run_until(TIMER0_GetTicks64() + SPAN);
+    done = 0;
+    for(i = 0; i < TEST_TIMERS; i++) {
+        TEST_CHECK(!SWTIMER_IsActive(&probes[i].timer));
+        done += probes[i].count > 0;
+    }
+    TEST_CHECK(done > TEST_TIMERS / 2);
+    TEST_EQUAL(probes[0].restarts, 3);
+    TEST_EQUAL(timer_sim_next_match(), ~(uint64_t)0);
+}
+
+int main(void) {
+    srand(11);
+    test_cascade(0);
+    test_cascade(0x123456789ULL);
+    test_cascade(WRAP - 7 * UNIT - 3);
+    test_parked();
+    test_match_wrap();
+    test_random();
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file     test_timer.c
+ * @brief    Host test of the time base: deadlines and elapsed times across the counter wraps
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * timer_drv.c as built for the target. TIMER0 is plain memory on the host: the test sets TC
+ * around 0, 2^31 and 2^32 and checks the wrap arithmetic at each.
+ *
+ **/
+
+#include "timer_drv.h"
+#include "test.h"
+
+static const uint32_t starts[] = {
+    0x00000000, 0x00000001,                                 // Just past a wrap
+    0x7FFFFFFE, 0x7FFFFFFF, 0x80000000, 0x80000001,         // Around 2^31
+    0xFFFFFFF0, 0xFFFFFFFE, 0xFFFFFFFF                      // Just before a wrap
+};
+
+static const uint32_t spans[] = {
+    0, 1, 2, TIMER_MIN_LEAD, 0x10000, 0x7FFFFFF0, 0x7FFFFFFE, 0x7FFFFFFF
+};
+
+#define COUNT(array)                        (sizeof(array) / sizeof((array)[0]))
+
+/**
+ * timer_deadline() 'span' ticks after each start: not expired one tick short, expired at the
+ * deadline and up to 2^31 - 1 ticks past it
+ */
+static void test_deadlines(void) {
+    uint32_t start, span, deadline;
+    unsigned int i, j;
+
+    for(i = 0; i < COUNT(starts); i++) {
+        for(j = 0; j < COUNT(spans); j++) {
+            start = starts[i];
+            span = spans[j];
+            LPC_TIM0->TC = start;
+            deadline = timer_deadline(span);
+            TEST_EQUAL(deadline, (uint32_t)(start + span));
+
+            TEST_CHECK(span == 0 || !timer_expired(deadline));
+            if(span) {
+                LPC_TIM0->TC = start + span - 1;
+                TEST_CHECK(!timer_expired(deadline));
+            }
+            LPC_TIM0->TC = start + span;
+            TEST_CHECK(timer_expired(deadline));
+            LPC_TIM0->TC = start + span + 1;
+            TEST_CHECK(timer_expired(deadline));
+            LPC_TIM0->TC = start + span + 0x7FFFFFFF;
+            TEST_CHECK(timer_expired(deadline));
+        }
+    }
+
+    // The longest documented span, from the last tick before a wrap
+    LPC_TIM0->TC = 0xFFFFFFFF;
+    deadline = timer_deadline(MSToTicks(TIMER_MAX_SPAN_MS));
+    LPC_TIM0->TC = deadline - 1;
+    TEST_CHECK(!timer_expired(deadline));
+    LPC_TIM0->TC = deadline;
+    TEST_CHECK(timer_expired(deadline));
+}
+
+/**
+ * timer_elapsed_ticks() and TIMER0_Elapse() across one wrap, up to 2^32 - 1 ticks
+ */
+static void test_elapsed(void) {
+    uint32_t start;
+    unsigned int i, j;
+
+    for(i = 0; i < COUNT(starts); i++) {
+        for(j = 0; j < COUNT(spans); j++) {
+            start = starts[i];
+            LPC_TIM0->TC = start + spans[j];
+            TEST_EQUAL(timer_elapsed_ticks(start), spans[j]);
+            TEST_EQUAL(TIMER0_Elapse(start), spans[j]);
+        }
+        LPC_TIM0->TC = start + 0xFFFFFFFF;
+        TEST_EQUAL(timer_elapsed_ticks(start), 0xFFFFFFFF);
+    }
+}
+
+/**
+ * TIMER0_GetTicks64() with the MR3 wrap flag pending, as when called with interrupts masked.
+ * The flag is plain memory here, not write-one-to-clear, so the interrupt is not run.
+ */
+static void test_ticks64(void) {
+    TIMER0_Init();
+    // What the counter reset and the IR write of TIMER0_Init() do on the chip
+    LPC_TIM0->TC = 0;
+    LPC_TIM0->IR = 0;
+    TEST_EQUAL(TIMER0_GetTicks64(), 0);
+
+    // MR3 matched on the last count: not wrapped yet
+    LPC_TIM0->TC = 0xFFFFFFFF;
+    LPC_TIM0->IR = IR_MR(TIMER_WRAP_CHANNEL);
+    TEST_EQUAL(TIMER0_GetTicks64(), 0xFFFFFFFFULL);
+
+    // Wrapped, the interrupt has not run: counted from the flag
+    LPC_TIM0->TC = 5;
+    TEST_EQUAL(TIMER0_GetTicks64(), 0x100000005ULL);
+
+    // Half a period later the interrupt must have run, the flag alone no longer counts
+    LPC_TIM0->TC = 0x80000000;
+    TEST_EQUAL(TIMER0_GetTicks64(), 0x80000000ULL);
+}
+
+int main(void) {
+    test_deadlines();
+    test_elapsed();
+    test_ticks64();
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file     timer_sim.c
+ * @brief    Host build: TIMER0 simulator standing in for timer_drv.c
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "timer_sim.h"
+
+#define NO_MATCH                            (~(uint64_t)0)
+#define SIM_EXCEPTION                       (16 + TIMER0_IRQn)
+
+static uint64_t now;
+static uint32_t matchValue[TIMER_MATCH_CHANNELS];
+static timer_match_callback matchCallbacks[TIMER_MATCH_CHANNELS];
+static unsigned int armed;                  //!< Bit n: MRn interrupt enabled
+static unsigned int pending;                //!< Bit n: MRn reached, interrupt not run yet
+static unsigned int running;
+static timer_sim_stats stats;
+
+
+/**
+ * \return Time base value at which the counter next reaches MRn, never 'now' itself
+ */
+static uint64_t match_time(unsigned int channel) {
+    uint32_t ahead = matchValue[channel] - (uint32_t)now;
+
+    return now + (ahead? ahead : (uint64_t)0x1 << 32);
+}
+
+uint64_t timer_sim_next_match(void) {
+    uint64_t next = NO_MATCH, when;
+    unsigned int channel;
+
+    for(channel = 0; channel < TIMER_MATCH_CHANNELS; channel++) {
+        if(armed & (0x1 << channel) & ~pending) {
+            when = match_time(channel);
+            if(when < next) {
+                next = when;
+            }
+        }
+    }
+
+    return next;
+}
+
+static void run_matches(void) {
+    timer_match_callback callback;
+    unsigned int channel;
+
+    for(channel = 0; channel < TIMER_MATCH_CHANNELS; channel++) {
+        if(pending & (0x1 << channel)) {
+            pending &= ~(0x1 << channel);
+            callback = matchCallbacks[channel];
+            if(callback && (armed & (0x1 << channel))) {
+                armed &= ~(0x1 << channel);
+                stats.interrupts++;
+                callback(channel);
+            }
+        }
+    }
+}
+
+/**
+ * Runs the pending matches as the TIMER0 interrupt, if it can be taken
+ */
+static void deliver(void) {
+    if(running || host_primask || !pending) {
+        return;
+    }
+    running = 1;
+    while(pending) {
+        host_run_handler(SIM_EXCEPTION, run_matches);
+    }
+    running = 0;
+}
+
+/**
+ * WFI: nothing else interrupts on the host, the next match wakes the core
+ */
+static void wait_for_match(void) {
+    uint64_t next = timer_sim_next_match();
+
+    if(pending) {
+        // Masked and pending: the core does not sleep
+        return;
+    }
+    if(next == NO_MATCH) {
+        fprintf(stderr, "timer_sim: WFI with no match armed, sleeping for ever\n");
+        exit(1);
+    }
+    timer_sim_run_until(next);
+}
+
+void timer_sim_reset(uint64_t ticks) {
+    now = ticks;
+    armed = 0;
+    pending = 0;
+    running = 0;
+    stats.interrupts = 0;
+    host_unmask_hook = deliver;
+    host_wfi_hook = wait_for_match;
+}
+
+void timer_sim_run_until(uint64_t ticks) {
+    uint64_t next;
+    unsigned int channel;
+
+    for(;;) {
+        next = timer_sim_next_match();
+        if(next > ticks) {
+            break;
+        }
+        now = next;
+        for(channel = 0; channel < TIMER_MATCH_CHANNELS; channel++) {
+            if((armed & (0x1 << channel)) && matchValue[channel] == (uint32_t)now) {
+                pending |= 0x1 << channel;
+            }
+        }
+        deliver();
+    }
+    if(ticks > now) {
+        now = ticks;
+    }
+}
+
+const timer_sim_stats *timer_sim_get_stats(void) {
+    return &stats;
+}
+
+/* TIMER0 API */
+
+void TIMER0_Init(void) {
+    timer_sim_reset(0);
+}
+
+unsigned int TIMER0_GetValue(void) {
+    return (uint32_t)now;
+}
+
+unsigned int timer_get_ticks(void) {
+    return (uint32_t)now;
+}
+
+uint64_t TIMER0_GetTicks64(void) {
+    return now;
+}
+
+uint64_t TIMER0_GetMicros(void) {
+    return now / TIMER_TICKS_PER_US;
+}
+
+void TIMER0_SetMatch(unsigned int channel, uint32_t ticks, timer_match_callback callback) {
+    matchCallbacks[channel] = callback;
+    matchValue[channel] = ticks;
+    pending &= ~(0x1 << channel);
+    armed |= 0x1 << channel;
+}
+
+void TIMER0_ClearMatch(unsigned int channel) {
+    armed &= ~(0x1 << channel);
+    pending &= ~(0x1 << channel);
+}
+
+static void sleep_wake(unsigned int channel) {
+}
+
+void TIMER0_WaitForInterrupt(uint64_t ticks) {
+    if(now >= ticks) {
+        return;
+    }
+    TIMER0_SetMatch(TIMER_SLEEP_CHANNEL, (uint32_t)((ticks > now + TIMER_MIN_LEAD)? ticks : now + TIMER_MIN_LEAD), sleep_wake);
+    __WFI();
+}
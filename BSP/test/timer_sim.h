@@ -0,0 +1,51 @@
+/**
+ * @file     timer_sim.h
+ * @brief    Host build: TIMER0 simulator standing in for timer_drv.c
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ * Implements the time base and match part of timer_drv.h on a simulated clock that only moves
+ * when told to. As on the chip, a match compares the low 32 bits of the time base: it fires when
+ * the 32-bit counter reaches it, which for a value already passed is after the next wrap. Its
+ * callback runs as the TIMER0 interrupt, at once if interrupts are enabled, else once PRIMASK
+ * is cleared. __WFI() moves the clock on to the next armed match.
+ *
+ **/
+
+#ifndef __TIMER_SIM_H__
+#define __TIMER_SIM_H__
+
+#include <stdint.h>
+
+#include "timer_drv.h"
+
+/// Counters since timer_sim_reset()
+typedef struct timer_sim_stats_t {
+    unsigned long interrupts;               //!< Match callbacks run
+} timer_sim_stats;
+
+/**
+ * Disarms every match and sets the time base
+ *
+ * \param ticks Time base value, as TIMER0_GetTicks64() will return it
+ */
+void timer_sim_reset(uint64_t ticks);
+
+/**
+ * Moves the clock forward, running the matches reached on the way, each at its own time
+ *
+ * \param ticks Time base value to stop at
+ */
+void timer_sim_run_until(uint64_t ticks);
+
+/**
+ * \return Time base value of the next armed match, ~0 if none
+ */
+uint64_t timer_sim_next_match(void);
+
+/**
+ * \return Counters since timer_sim_reset()
+ */
+const timer_sim_stats *timer_sim_get_stats(void);
+
+#endif /* __TIMER_SIM_H__ */
@@ -34,116 +34,42 @@
 #include <stdbool.h>
 
 #include <nxp/iolpc1768.h>
-#include <assert.h>
 
 #include "board.h"
 
 #include "LPC17xx.h"
-
-#define TIMER0_TICK_PER_SEC   10
-#define TIMER0_IN_FREQ        25000000
+#include "main.h"
+#include "timer_drv.h"
+#include "swtimer.h"
+#include "sched.h"
+#include "irq_drv.h"
+#include "prof.h"
+#include "irqtrace.h"
+#include "stack.h"
+#include "ssp_drv.h"
+#include "spi_drv.h"
+#include "common.h"
+
+#define LED1_TOGGLE_PER_SEC   10
 
 /*variable for critical section entry control*/
 Int32U CriticalSecCntr;
-/*************************************************************************
- * Function Name: NVIC_IntEnable
- * Parameters: IntNumber - Interrupt number
- * Return: void
- *
- * Description: Enable interrupt at NVIC
- *
- *
- *************************************************************************/
-void NVIC_IntEnable(Int32U IntNumber)
-{
-volatile unsigned long * pNVIC_SetEn = &SETENA0;
-
-  assert((NVIC_WDT <= IntNumber) && (NVIC_PLL1 >= IntNumber));
-  IntNumber -= NVIC_WDT;
 
-  pNVIC_SetEn += IntNumber/32;
-  *pNVIC_SetEn = (1UL<<(IntNumber%32));
-
-}
+static swtimer led1Timer;
 
 /*************************************************************************
- * Function Name: NVIC_IntDisable
- * Parameters: IntNumber - Interrupt number
- * Return: void
- *
- * Description: Disables interrupt at NVIC
- *
- *
- *************************************************************************/
-void NVIC_IntDisable(Int32U IntNumber)
-{
-volatile unsigned long * pNVIC_ClrEn = &CLRENA0;
-
-  assert((NVIC_WDT <= IntNumber) && (NVIC_PLL1 >= IntNumber));
-  IntNumber -= NVIC_WDT;
-
-  pNVIC_ClrEn += IntNumber/32;
-  *pNVIC_ClrEn = (1UL<<(IntNumber%32));
-
-}
-
-/*************************************************************************
- * Function Name: NVIC_ClrPend
- * Parameters: IntNumber - Interrupt number
- * Return: void
- *
- * Description:Clear pending interrupt at NVIC
- *
- *
- *************************************************************************/
-void NVIC_ClrPend(Int32U IntNumber)
-{
-volatile unsigned long * pNVIC_ClrPend = &CLRPEND0;
-
-  assert((NVIC_WDT <= IntNumber) && (NVIC_PLL1 >= IntNumber));
-  IntNumber -= NVIC_WDT;
-
-  pNVIC_ClrPend += IntNumber/32;
-  *pNVIC_ClrPend = (1UL<<(IntNumber%32));
-
-}
-
-/*************************************************************************
- * Function Name: NVIC_ClrPend
- * Parameters: IntNumber - Interrupt number, Interrupt Priority
- * Return: void
- *
- * Description:Sets Interrupt priority
- *
- *
- *************************************************************************/
-void NVIC_IntPri(Int32U IntNumber, Int8U Priority)
-{
-volatile Int8U * pNVIC_IntPri = (Int8U *)&IP0;
-
-  assert((NVIC_WDT <= IntNumber) && (NVIC_PLL1 >= IntNumber));
-  IntNumber -= NVIC_WDT;
-  pNVIC_IntPri += IntNumber;
-  *pNVIC_IntPri = Priority;
-}
-
-/*************************************************************************
- * Function Name: TMR0_IRQHandler
- * Parameters: none
+ * Function Name: Led1Blink
+ * Parameters: timer - LED1 timer, ctx - unused
  *
  * Return: none
  *
- * Description: Timer 0 interrupt handler
+ * Description: Software timer callback, toggles LED1
  *
  *************************************************************************/
-void TMR0_IRQHandler (void)
+static void Led1Blink(swtimer *timer, void *ctx)
 {
   /* Toggle LED1 */
   LED1_FIO ^= LED1_MASK;
-  /*clear interrupt */
-  T0IR_bit.MR0INT = 1;
-  /**/
-  NVIC_ClrPend(NVIC_TIMER0);
 }
 
 #define FCCLK_FREQ 100000000
@@ -174,7 +100,11 @@ void InitClock(void)
   PLL0FEED = 0x55;
   // 5. Select source clock for PLL
   CLKSRCSEL_bit.CLKSRC = 1;   // Selects the main oscillator as a PLL clock source.
-  PCLKSEL0 = PCLKSEL1  = 0;   // other peripherals 100/4 = 25MHz
+  // other peripherals 100/4 = 25MHz; SSP0, SSP1 and SPI at CCLK for their fastest bit rates.
+  // Only here, before PLL0 is connected, is PCLKSEL sure to take (erratum PCLKSELx.1): the
+  // drivers read it back and never write it
+  PCLKSEL0 = (CLOCK_MODE_SAME_AS_CCLOCK << SSP1_CLOCK_MODE_SHIFT) | (CLOCK_MODE_SAME_AS_CCLOCK << SPI_CLOCK_MODE_SHIFT);
+  PCLKSEL1 = (CLOCK_MODE_SAME_AS_CCLOCK << SSP0_CLOCK_MODE_SHIFT);
   // 6. Set PLL settings 300 MHz
   PLL0CFG_bit.MSEL = 25-1;
   PLL0CFG_bit.NSEL = 2-1;
@@ -229,14 +159,6 @@ void GpioInit(void)
   PINSEL9 = 0;
 }
 
-void systick_setup(uint32_t sys_freq) {
-    SysTick->LOAD = (sys_freq / 1000U) - 1U; //1ms tick
-    SysTick->VAL = 0x00; //explicitly set start value (undefined on reset)
-    SysTick->CTRL |= (1U << SysTick_CTRL_TICKINT_Pos) | (1U << SysTick_CTRL_CLKSOURCE_Pos); //enable systick interrupt, source processor clock
-    SCB->SHP[8] = 0U;   //set SysTick interrupt priority (default: 0, the highest)
-    SysTick->CTRL |= (1U << SysTick_CTRL_ENABLE_Pos); //enable SysTick
-}
-    
 /*************************************************************************
  * Function Name: main
  * Parameters: none
@@ -248,10 +170,15 @@ void systick_setup(uint32_t sys_freq) {
  *************************************************************************/
 int main(void)
 {
+  // Interrupt priorities, before anything enables one
+  IRQ_Init();
+  // Stack painting and overflow guard
+  STACK_Init();
   // Flash accelerator init
   FLASHCFG = (0x5UL<<12) | 0x3AUL;
   // Init clock
   InitClock();
+  SystemCoreClockUpdate();
 #if FCCLK_FREQ < 20000000
   FLASHCFG = (0x0UL<<12) | 0x3AUL;
 #elif FCCLK_FREQ < 40000000
@@ -269,47 +196,27 @@ int main(void)
   LED1_FDIR = LED1_MASK;
   LED1_FSET = LED1_MASK;
 
-  // Enable TIM0 clocks
-  PCONP_bit.PCTIM0 = 1; // enable clock
-
-  // Init Time0
-  T0TCR_bit.CE = 0;     // counting  disable
-  T0TCR_bit.CR = 1;     // set reset
-  T0TCR_bit.CR = 0;     // release reset
-  T0CTCR_bit.CTM = 0;   // Timer Mode: every rising PCLK edge
-  T0MCR_bit.MR0I = 1;   // Enable Interrupt on MR0
-  T0MCR_bit.MR0R = 1;   // Enable reset on MR0
-  T0MCR_bit.MR0S = 0;   // Disable stop on MR0
-  // set timer 0 period
-  T0PR = 18-1;
-  T0MR0 = (TIMER0_IN_FREQ)/(18 * TIMER0_TICK_PER_SEC);
-  // init timer 0 interrupt
-  T0IR_bit.MR0INT = 1;  // clear pending interrupt
-  T0TCR_bit.CE = 1;     // counting Enable
-  /*Enable NVIC TMR0 Interrupt*/
-  NVIC_IntEnable(NVIC_TIMER0);
+  // Time base, TIMER0 free running
+  TIMER0_Init();
+#if PROF_ENABLED
+  PROF_Init();
+#endif
+#if IRQTRACE_ENABLED
+  IRQTRACE_Init();
+#endif
   __enable_interrupt();
-  
-  systick_setup(100000000);
-  /*Enable NVIC systick Interrupt*/
-  NVIC_IntEnable(STI);
-  
-  while(1)
-  {
-    
-  }
-}
 
-uint32_t u32sysTick;
+  SWTIMER_Init();
+  SCHED_Init();
 
-void SysTick_Handler(void)
-{
-  u32sysTick++;
+  SWTIMER_Setup(&led1Timer, Led1Blink, 0);
+  SWTIMER_Start(&led1Timer, 1000000 / LED1_TOGGLE_PER_SEC, 1000000 / LED1_TOGGLE_PER_SEC);
+
+  // Runs the tasks, sleeping whenever none is ready
+  SCHED_Run();
 }
 
 void Delay(uint32_t delay)
 {
-  uint32_t start_systick = u32sysTick;
-  while (u32sysTick < delay + start_systick)
-    ;
+  TIMER0_SleepUntil(TIMER0_GetTicks64() + (uint64_t)delay * (TIMER_TICK_HZ / 1000));
 }
@@ -0,0 +1,21 @@
+/**
+ * @file     main.h
+ * @brief    Application services used by the drivers
+ * @version  1.0
+ * @date     19 Oct. 2026
+ *
+ **/
+
+#ifndef __MAIN_H__
+#define __MAIN_H__
+
+#include <stdint.h>
+
+/**
+ * Sleeps on the TIMER0 time base, see TIMER0_SleepUntil(). TIMER0_Init() must have been called.
+ *
+ * \param delay Milliseconds
+ */
+void Delay(uint32_t delay);
+
+#endif /* __MAIN_H__ */
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Decodes an interrupt trace exported by IRQTRACE_Export() (BSP/src/drivers/irqtrace.c).
+
+Prints the timeline, one line per handler entry and exit, indented by nesting, then per
+exception statistics. Times are in microseconds from the first event.
+
+    usage: irqtrace_decode.py trace.bin [--summary]
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER = struct.Struct('<4sBBHIII')
+EVENT = struct.Struct('<IBBH')
+NO_LATENCY = 0xFFFF
+MAX_LATENCY = 0xFFFE                        # Saturated: at least this many cycles
+ENTER, EXIT = 0, 1
+
+CORE_EXCEPTIONS = ['Thread', 'Reset', 'NMI', 'HardFault', 'MemManage', 'BusFault', 'UsageFault',
+                   'Reserved7', 'Reserved8', 'Reserved9', 'Reserved10', 'SVCall', 'DebugMon',
+                   'Reserved13', 'PendSV', 'SysTick']
+LPC17XX_IRQS = ['WDT', 'TIMER0', 'TIMER1', 'TIMER2', 'TIMER3', 'UART0', 'UART1', 'UART2', 'UART3',
+                'PWM1', 'I2C0', 'I2C1', 'I2C2', 'SPI', 'SSP0', 'SSP1', 'PLL0', 'RTC', 'EINT0',
+                'EINT1', 'EINT2', 'EINT3', 'ADC', 'BOD', 'USB', 'CAN', 'DMA', 'I2S', 'ENET',
+                'RIT', 'MCPWM', 'QEI', 'PLL1', 'USBActivity', 'CANActivity']
+
+
+def exception_name(number):
+    if number < 16:
+        return CORE_EXCEPTIONS[number]
+    if number - 16 < len(LPC17XX_IRQS):
+        return LPC17XX_IRQS[number - 16]
+    return 'IRQ%d' % (number - 16)
+
+
+def load(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        sys.exit('%s: too short for a trace' % path)
+    magic, version, size, _, clock, count, lost = HEADER.unpack_from(data)
+    if magic != b'IRQT' or version != 1 or size != EVENT.size:
+        sys.exit('%s: not an IRQTRACE version 1 export' % path)
+    available = (len(data) - HEADER.size) // EVENT.size
+    if available < count:
+        print('warning: %d events announced, %d present' % (count, available), file=sys.stderr)
+        count = available
+    events = [EVENT.unpack_from(data, HEADER.size + i * EVENT.size) for i in range(count)]
+    return clock, lost, events
+
+
+def unwrap(events):
+    """Makes the 32 bit cycle counts monotonic, assuming less than a wrap between events"""
+    total, last = 0, None
+    for cycles, exception, kind, latency in events:
+        if last is not None:
+            total += (cycles - last) & 0xFFFFFFFF
+        last = cycles
+        yield total, exception, kind, latency
+
+
+class Stats:
+    def __init__(self):
+        self.latencies = []
+        self.saturated = 0                  # Latencies of MAX_LATENCY cycles or more
+        self.durations = []
+        self.preempted = {}                 # By exception: times it nested in this one
+
+
+def decode(clock, events, show_timeline):
+    us = 1e6 / clock
+    stats = {}
+    stack = []                              # (exception, entry cycles)
+
+    for cycles, exception, kind, latency in unwrap(events):
+        entry = stats.setdefault(exception, Stats())
+        name = exception_name(exception)
+        if kind == ENTER:
+            if stack:
+                stats[stack[-1][0]].preempted[exception] = stats[stack[-1][0]].preempted.get(exception, 0) + 1
+            if latency != NO_LATENCY:
+                entry.latencies.append(latency)
+                entry.saturated += latency == MAX_LATENCY
+            if show_timeline:
+                extra = ''
+                if latency != NO_LATENCY:
+                    extra = '  latency %s%.2f us' % ('>= ' if latency == MAX_LATENCY else '', latency * us)
+                print('%12.2f %s> %s%s' % (cycles * us, '  ' * len(stack), name, extra))
+            stack.append((exception, cycles))
+        else:
+            # Events before the start of the trace may be missing: unmatched exits are skipped
+            if not stack or stack[-1][0] != exception:
+                if show_timeline:
+                    print('%12.2f %s< %s  (entry not traced)' % (cycles * us, '  ' * len(stack), name))
+                continue
+            _, start = stack.pop()
+            entry.durations.append(cycles - start)
+            if show_timeline:
+                print('%12.2f %s< %s  %.2f us' % (cycles * us, '  ' * len(stack), name, (cycles - start) * us))
+    return stats
+
+
+def summarize(values, us, saturated=0):
+    """min / mean / max; with saturated values the mean and the max are lower bounds"""
+    if not values:
+        return '-'
+    bound = '>=' if saturated else ''
+    return '%.2f / %s%.2f / %s%.2f' % (min(values) * us, bound, sum(values) * us / len(values),
+                                      bound, max(values) * us)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('trace', help='binary export')
+    parser.add_argument('--summary', action='store_true', help='statistics only, no timeline')
+    args = parser.parse_args()
+
+    clock, lost, events = load(args.trace)
+    print('%d events, core clock %d Hz, %d older events lost' % (len(events), clock, lost))
+    stats = decode(clock, events, not args.summary)
+
+    us = 1e6 / clock
+    print()
+    print('%-12s %6s  %-30s %-26s %s' % ('exception', 'count', 'latency us min/mean/max',
+                                       'duration us min/mean/max', 'preempted by'))
+    for exception in sorted(stats):
+        entry = stats[exception]
+        preempted = ', '.join('%s x%d' % (exception_name(e), n) for e, n in sorted(entry.preempted.items()))
+        print(('%-12s %6d  %-30s %-26s %s' % (exception_name(exception), len(entry.durations),
+                                              summarize(entry.latencies, us, entry.saturated),
+                                              summarize(entry.durations, us), preempted)).rstrip())
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,300 @@
+#!/usr/bin/env python3
+"""Memory usage report from the IAR ILINK map of the project.
+
+Reports, from the PLACEMENT SUMMARY and ENTRY LIST of the map:
+  - per region of the ICF: used, free, and what it holds (code, constants, data), the EMAC
+    descriptors and buffers counted as data of their region;
+  - per module: code, constants, data, and what of it is in RAM;
+  - the largest symbols.
+Then checks that no linker placed section overlaps the EMAC descriptors and buffers, laid out
+by hand from RX_DESC_BASE in ethernet_drv.h, and that the budgets hold.
+
+Exits with 1 on a collision or a budget exceeded, 2 when an input cannot be read.
+
+    usage: memreport.py Flash/List/LPC1768-IAR.map [--icf config/LPC1768_Flash.icf]
+                        [--budgets tools/membudget.cfg] [--symbols 20]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+KINDS = {
+    'ro code': 'code', 'rw code': 'code',
+    'const': 'const', 'ro data': 'const', 'ro': 'const',
+    'inited': 'data', 'zero': 'data', 'uninit': 'data', 'rw data': 'data', 'rw': 'data',
+}
+PLACEMENT = re.compile(r"^\s+(.+?)\s+(%s)\s+(0x[0-9a-fA-F']+)\s+(0x[0-9a-fA-F']+)\s*(.*)$"
+                       % '|'.join(sorted(KINDS, key=len, reverse=True)))
+RAM_REGIONS = ('RAM_region', 'AHB_RAM_region')
+ENTRY = re.compile(r"^(\S+)\s+(0x[0-9a-fA-F']+)\s+(0x[0-9a-fA-F']+)\s+(Code|Data)\s+(Gb|Lc|Wk)\s+(.*)$")
+
+
+def number(text):
+    text = text.replace("'", '').strip()
+    return int(text, 0)
+
+
+def die(message):
+    print('error: ' + message, file=sys.stderr)
+    sys.exit(2)
+
+
+def read(path):
+    try:
+        with open(path, encoding='latin-1') as f:
+            return f.read()
+    except OSError as e:
+        die('%s: %s' % (path, e.strerror))
+
+
+# ICF
+
+def parse_icf(path):
+    """\\return {region: [(start, end inclusive)...]}, holes taken out"""
+    text = re.sub(r'/\*.*?\*/', '', read(path), flags=re.S)
+    symbols = {}
+    for name, value in re.findall(r'define\s+symbol\s+(\w+)\s*=\s*([^;]+);', text):
+        symbols[name] = evaluate(value, symbols)
+
+    regions = {}
+    for name, body in re.findall(r'define\s+region\s+(\w+)\s*=\s*([^;]+);', text):
+        ranges = []
+        for sign, start, end in re.findall(r'(^|[-+|])\s*mem:\[\s*from\s+(\S+)\s+to\s+([^\]]+?)\s*\]', body.strip()):
+            span = (evaluate(start, symbols), evaluate(end, symbols))
+            if sign == '-':
+                ranges = subtract(ranges, span)
+            else:
+                ranges.append(span)
+        regions[name] = ranges
+    return regions
+
+
+def evaluate(expression, symbols):
+    expression = re.sub(r'\b([A-Za-z_]\w*)\b', lambda m: str(symbols.get(m.group(1), m.group(1))), expression)
+    try:
+        return int(eval(expression, {'__builtins__': {}}))
+    except Exception:
+        die('cannot evaluate "%s"' % expression)
+
+
+def subtract(ranges, hole):
+    result = []
+    for start, end in ranges:
+        if hole[1] < start or hole[0] > end:
+            result.append((start, end))
+            continue
+        if start < hole[0]:
+            result.append((start, hole[0] - 1))
+        if end > hole[1]:
+            result.append((hole[1] + 1, end))
+    return result
+
+
+def region_of(address, regions):
+    for name, ranges in regions.items():
+        for start, end in ranges:
+            if start <= address <= end:
+                return name
+    return None
+
+
+# Map
+
+def section(text, title):
+    """\\return The lines of a '*** TITLE' part of the map"""
+    match = re.search(r'\*\*\* %s\s*\n\*\*\*\s*\n(.*?)(?=\n\*{20,}|\Z)' % title, text, re.S)
+    return match.group(1).splitlines() if match else []
+
+
+def parse_placements(text):
+    placements = []
+    for line in section(text, 'PLACEMENT SUMMARY'):
+        match = PLACEMENT.match(line)
+        if not match:
+            continue
+        name, kind, address, size, obj = match.groups()
+        name, obj = name.strip(), re.sub(r'\s*\[\d+\]$', '', obj.strip())
+        if obj.startswith('<Block'):
+            obj = '<%s>' % name                     # CSTACK, HEAP
+        elif obj.startswith('<for '):
+            obj = '<initializers>'                  # Flash copy of what is initialized by copy
+        if name == '.ramfunc':
+            kind = 'rw code'                        # RAMFUNC: code, reported 'inited'
+        placements.append({'name': name, 'kind': KINDS[kind], 'address': number(address),
+                           'size': number(size), 'object': obj or '?'})
+    if not placements:
+        die('no PLACEMENT SUMMARY entries: not an ILINK map, or the map option is off')
+    return placements
+
+
+def parse_entries(text):
+    entries = []
+    for line in section(text, 'ENTRY LIST'):
+        match = ENTRY.match(line.strip())
+        if match:
+            name, address, size, kind, _, obj = match.groups()
+            entries.append({'name': name, 'address': number(address) & ~1 if kind == 'Code' else number(address),
+                            'size': number(size), 'kind': kind,
+                            'object': re.sub(r'\s*\[\d+\]$', '', obj.strip())})
+    return entries
+
+
+# EMAC layout
+
+def emac_layout(header):
+    """\\return [(name, start, end exclusive)] of the hand placed EMAC areas"""
+    defines = {}
+    for name, value in re.findall(r'^#define\s+(\w+)\s+([^/\n]+)', read(header), re.M):
+        defines[name] = value.strip()
+
+    def value(name):
+        expression = defines[name]
+        expression = re.sub(r'\b([A-Za-z_]\w*)\b', lambda m: '(%d)' % value(m.group(1)), expression)
+        return int(eval(expression, {'__builtins__': {}}))
+
+    try:
+        rx, tx, frag = value('NUM_RX_FRAG'), value('NUM_TX_FRAG'), value('ETH_FRAG_SIZE')
+        dword, word = value('DWORD'), value('WORD')
+        return [('RX descriptors', value('RX_DESC_BASE'), value('RX_DESC_BASE') + rx * dword),
+                ('RX status', value('RX_STAT_BASE'), value('RX_STAT_BASE') + rx * dword),
+                ('TX descriptors', value('TX_DESC_BASE'), value('TX_DESC_BASE') + tx * dword),
+                ('TX status', value('TX_STAT_BASE'), value('TX_STAT_BASE') + tx * word),
+                ('RX buffers', value('RX_BUF_BASE'), value('RX_BUF_BASE') + rx * frag),
+                ('TX buffers', value('TX_BUF_BASE'), value('TX_BUF_BASE') + tx * frag)]
+    except (KeyError, RecursionError):
+        die('%s: EMAC layout defines not found' % header)
+
+
+# Budgets
+
+def parse_budgets(path, regions):
+    """\\return [(kind, name, limit in bytes)]; a line: region|module <name> <bytes|nK|n%>.
+    A region limit is on all it holds, a module limit on what the module takes in RAM."""
+    budgets = []
+    for number_, line in enumerate(read(path).splitlines(), 1):
+        line = line.split('#')[0].strip()
+        if not line:
+            continue
+        fields = line.split()
+        if len(fields) != 3 or fields[0] not in ('region', 'module'):
+            die('%s:%d: expected "region|module <name> <limit>"' % (path, number_))
+        kind, name, limit = fields
+        if limit.endswith('%'):
+            if kind != 'region' or name not in regions:
+                die('%s:%d: a percentage needs a region of the ICF' % (path, number_))
+            limit = region_size(regions[name]) * float(limit[:-1]) / 100
+        elif limit[-1] in 'kK':
+            limit = number(limit[:-1]) * 1024
+        else:
+            limit = number(limit)
+        budgets.append((kind, name, int(limit)))
+    return budgets
+
+
+def region_size(ranges):
+    return sum(end - start + 1 for start, end in ranges)
+
+
+def kb(size):
+    return '%.1fK' % (size / 1024.0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('map', help='ILINK map file')
+    parser.add_argument('--icf', default=os.path.join(ROOT, 'config', 'LPC1768_Flash.icf'))
+    parser.add_argument('--emac', default=os.path.join(ROOT, 'BSP', 'inc', 'drivers', 'ethernet_drv.h'),
+                        help='header with the EMAC layout')
+    parser.add_argument('--budgets', default=os.path.join(ROOT, 'tools', 'membudget.cfg'))
+    parser.add_argument('--symbols', type=int, default=20, help='largest symbols listed')
+    args = parser.parse_args()
+
+    regions = parse_icf(args.icf)
+    text = read(args.map)
+    placements = parse_placements(text)
+    entries = parse_entries(text)
+    layout = emac_layout(args.emac)
+    failed = False
+
+    # Regions, with the EMAC layout: the linker does not see it, the budgets must
+    used = dict((name, {'code': 0, 'const': 0, 'data': 0}) for name in regions)
+    outside = []
+    for entry in placements:
+        name = region_of(entry['address'], regions)
+        if name:
+            used[name][entry['kind']] += entry['size']
+        elif entry['size']:
+            outside.append(entry)
+    for area, area_start, area_end in layout:
+        name = region_of(area_start, regions)
+        if name:
+            used[name]['data'] += area_end - area_start
+    print('%-16s %9s %9s %9s %9s %9s %6s' % ('region', 'size', 'code', 'const', 'data', 'free', 'used'))
+    for name in sorted(regions):
+        size = region_size(regions[name])
+        total = sum(used[name].values())
+        print('%-16s %9d %9d %9d %9d %9d %5.1f%%' % (name, size, used[name]['code'], used[name]['const'],
+                                                  used[name]['data'], size - total, 100.0 * total / size))
+    for entry in outside:
+        print('warning: %s (%s) at 0x%08X is in no region' % (entry['name'], entry['object'], entry['address']))
+
+    # Modules
+    modules = {}
+    for entry in placements:
+        module = modules.setdefault(entry['object'], {'code': 0, 'const': 0, 'data': 0, 'ram': 0})
+        module[entry['kind']] += entry['size']
+        if region_of(entry['address'], regions) in RAM_REGIONS:
+            module['ram'] += entry['size']
+    print()
+    print('%-32s %9s %9s %9s %9s' % ('module', 'code', 'const', 'data', 'ram'))
+    for name, module in sorted(modules.items(), key=lambda item: (-item[1]['ram'], item[0])):
+        print('%-32s %9d %9d %9d %9d' % (name[:32], module['code'], module['const'], module['data'],
+                                         module['ram']))
+
+    # Symbols
+    if args.symbols and entries:
+        print()
+        print('%-32s %10s %7s %-14s %s' % ('symbol', 'address', 'size', 'region', 'module'))
+        for entry in sorted(entries, key=lambda e: -e['size'])[:args.symbols]:
+            print('%-32s 0x%08X %7d %-14s %s' % (entry['name'][:32], entry['address'], entry['size'],
+                                                region_of(entry['address'], regions) or '-', entry['object']))
+
+    # EMAC layout against what the linker placed
+    print()
+    start, end = layout[0][1], max(area[2] for area in layout)
+    print('EMAC layout 0x%08X-0x%08X (%s)' % (start, end - 1, kb(end - start)))
+    if not region_of(start, regions) or region_of(start, regions) != region_of(end - 1, regions):
+        print('error: the EMAC layout is not within one region of the ICF')
+        failed = True
+    for entry in placements:
+        if not entry['size'] or entry['address'] >= end or entry['address'] + entry['size'] <= start:
+            continue
+        for name, area_start, area_end in layout:
+            if entry['address'] < area_end and entry['address'] + entry['size'] > area_start:
+                print('error: %s (%s) 0x%08X-0x%08X overlaps the EMAC %s' % (
+                    entry['name'], entry['object'], entry['address'], entry['address'] + entry['size'] - 1, name))
+                failed = True
+
+    # Budgets
+    if os.path.exists(args.budgets):
+        print()
+        for kind, name, limit in parse_budgets(args.budgets, regions):
+            if kind == 'region':
+                if name not in used:
+                    die('%s: no region %s in the ICF' % (args.budgets, name))
+                total = sum(used[name].values())
+            else:
+                total = modules.get(name, {}).get('ram', 0)
+            status = 'ok' if total <= limit else 'OVER'
+            print('budget %-6s %-24s %9d / %9d %s' % (kind, name, total, limit, status))
+            failed |= total > limit
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()